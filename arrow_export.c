@@ -0,0 +1,539 @@
+#include "arrow_export.h"
+#include "bin_reader.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// Arrow constants from Schema.fbs / Message.fbs.
+#define ARROW_METADATA_V5 4
+#define ARROW_TYPE_INT 2
+#define ARROW_TYPE_FLOATING_POINT 3
+#define ARROW_TYPE_UTF8 5
+#define ARROW_PRECISION_SINGLE 1
+#define ARROW_PRECISION_DOUBLE 2
+#define ARROW_HEADER_SCHEMA 1
+#define ARROW_HEADER_DICTIONARY_BATCH 2
+#define ARROW_HEADER_RECORD_BATCH 3
+
+#define ARROW_ALIGNMENT 64 // Buffer alignment; Arrow requires 8 and recommends 64
+#define ARROW_SYMBOL_DICTIONARY_ID 0
+#define ARROW_MAX_BUFFERS (3 + 2 * MAX_SCHEMA_FIELDS)
+
+static const char ARROW_FILE_MAGIC[6] = { 'A', 'R', 'R', 'O', 'W', '1' };
+
+// --- Minimal flatbuffer builder ---
+// Builds front to back: a table is written with placeholder offset slots,
+// its vtable goes right after it, and children are appended later and
+// patched in. Offsets therefore always point forward, as flatbuffers
+// require. All scalars are stored little-endian whatever the host order.
+
+#define FB_MAX_TABLE_FIELDS 8
+
+typedef struct {
+    unsigned char *data;
+    size_t len;
+    size_t capacity;
+    bool failed;
+} FbBuilder;
+
+typedef struct {
+    size_t start;
+    uint16_t field_offset[FB_MAX_TABLE_FIELDS];
+    int num_fields; // Highest field id written + 1
+} FbTable;
+
+static void fb_init(FbBuilder *b) {
+    memset(b, 0, sizeof(*b));
+}
+
+static void fb_free(FbBuilder *b) {
+    free(b->data);
+    memset(b, 0, sizeof(*b));
+}
+
+static void fb_reset(FbBuilder *b) {
+    b->len = 0;
+    b->failed = false;
+}
+
+static bool fb_reserve(FbBuilder *b, size_t extra) {
+    if (b->failed) return false;
+    if (b->len + extra <= b->capacity) return true;
+    size_t new_capacity = b->capacity ? b->capacity * 2 : 1024;
+    while (new_capacity < b->len + extra) new_capacity *= 2;
+    unsigned char *temp = realloc(b->data, new_capacity);
+    if (!temp) {
+        perror("❌ Failed to grow Arrow metadata buffer");
+        b->failed = true;
+        return false;
+    }
+    b->data = temp;
+    b->capacity = new_capacity;
+    return true;
+}
+
+static void fb_set_le(FbBuilder *b, size_t pos, uint64_t value, size_t size) {
+    for (size_t i = 0; i < size; ++i) b->data[pos + i] = (unsigned char)(value >> (8 * i));
+}
+
+static void fb_put_le(FbBuilder *b, uint64_t value, size_t size) {
+    if (!fb_reserve(b, size)) return;
+    fb_set_le(b, b->len, value, size);
+    b->len += size;
+}
+
+static void fb_put_bytes(FbBuilder *b, const void *bytes, size_t n) {
+    if (!fb_reserve(b, n)) return;
+    memcpy(b->data + b->len, bytes, n);
+    b->len += n;
+}
+
+// Appends zeros until len % align == phase.
+static void fb_pad_to(FbBuilder *b, size_t align, size_t phase) {
+    while (!b->failed && b->len % align != phase) fb_put_le(b, 0, 1);
+}
+
+static void fb_patch_offset(FbBuilder *b, size_t slot, size_t target) {
+    if (!b->failed) fb_set_le(b, slot, target - slot, sizeof(uint32_t));
+}
+
+static void fb_table_begin(FbBuilder *b, FbTable *t) {
+    fb_pad_to(b, sizeof(uint32_t), 0);
+    memset(t, 0, sizeof(*t));
+    t->start = b->len;
+    fb_put_le(b, 0, sizeof(int32_t)); // soffset to the vtable, patched in fb_table_end
+}
+
+static size_t fb_add_field(FbBuilder *b, FbTable *t, int id, uint64_t value, size_t size) {
+    fb_pad_to(b, size, 0);
+    size_t pos = b->len;
+    t->field_offset[id] = (uint16_t)(pos - t->start);
+    if (id >= t->num_fields) t->num_fields = id + 1;
+    fb_put_le(b, value, size);
+    return pos;
+}
+
+// Reserves an offset slot for a child object; patch it with fb_patch_offset.
+static size_t fb_add_offset(FbBuilder *b, FbTable *t, int id) {
+    return fb_add_field(b, t, id, 0, sizeof(uint32_t));
+}
+
+static void fb_table_end(FbBuilder *b, FbTable *t) {
+    size_t table_size = b->len - t->start;
+    fb_pad_to(b, sizeof(uint16_t), 0);
+    size_t vtable = b->len;
+    fb_put_le(b, sizeof(uint16_t) * (2 + (size_t)t->num_fields), sizeof(uint16_t));
+    fb_put_le(b, table_size, sizeof(uint16_t));
+    for (int i = 0; i < t->num_fields; ++i) fb_put_le(b, t->field_offset[i], sizeof(uint16_t));
+    // The vtable lives after the table, so the signed offset is negative.
+    if (!b->failed) fb_set_le(b, t->start, (uint32_t)(int32_t)((int64_t)t->start - (int64_t)vtable), sizeof(int32_t));
+}
+
+// Writes a vector length so that the elements that follow are elem_align aligned.
+static size_t fb_vector_begin(FbBuilder *b, size_t count, size_t elem_align) {
+    size_t align = elem_align > sizeof(uint32_t) ? elem_align : sizeof(uint32_t);
+    fb_pad_to(b, align, align - sizeof(uint32_t));
+    size_t pos = b->len;
+    fb_put_le(b, count, sizeof(uint32_t));
+    return pos;
+}
+
+static size_t fb_string(FbBuilder *b, const char *s, size_t len) {
+    size_t pos = fb_vector_begin(b, len, 1);
+    fb_put_bytes(b, s, len);
+    fb_put_le(b, 0, 1);
+    return pos;
+}
+
+static size_t fb_empty_table(FbBuilder *b) {
+    FbTable t;
+    fb_table_begin(b, &t);
+    fb_table_end(b, &t);
+    return t.start;
+}
+
+static size_t fb_int_type(FbBuilder *b, int bit_width) {
+    FbTable t;
+    fb_table_begin(b, &t);
+    fb_add_field(b, &t, 0, (uint32_t)bit_width, sizeof(int32_t)); // bitWidth
+    fb_add_field(b, &t, 1, 1, sizeof(uint8_t));                   // is_signed
+    fb_table_end(b, &t);
+    return t.start;
+}
+
+// Field{name, nullable, type_type, type, dictionary, children}. children is
+// always written because readers reject fields without it.
+static size_t fb_field(FbBuilder *b, const char *name, uint8_t type_type, bool dictionary_encoded,
+                       const FieldDesc *column) {
+    FbTable t;
+    fb_table_begin(b, &t);
+    size_t name_slot = fb_add_offset(b, &t, 0);
+    fb_add_field(b, &t, 1, 0, sizeof(uint8_t)); // nullable: no column has nulls
+    fb_add_field(b, &t, 2, type_type, sizeof(uint8_t));
+    size_t type_slot = fb_add_offset(b, &t, 3);
+    size_t dictionary_slot = dictionary_encoded ? fb_add_offset(b, &t, 4) : 0;
+    size_t children_slot = fb_add_offset(b, &t, 5);
+    fb_table_end(b, &t);
+
+    fb_patch_offset(b, name_slot, fb_string(b, name, strlen(name)));
+    if (type_type == ARROW_TYPE_INT) {
+        fb_patch_offset(b, type_slot, fb_int_type(b, column->width * 8));
+    } else if (type_type == ARROW_TYPE_FLOATING_POINT) {
+        FbTable fp;
+        fb_table_begin(b, &fp);
+        fb_add_field(b, &fp, 0, column->width == sizeof(double) ? ARROW_PRECISION_DOUBLE : ARROW_PRECISION_SINGLE,
+                     sizeof(int16_t));
+        fb_table_end(b, &fp);
+        fb_patch_offset(b, type_slot, fp.start);
+    } else {
+        fb_patch_offset(b, type_slot, fb_empty_table(b)); // Utf8 has no attributes
+    }
+    if (dictionary_encoded) {
+        // DictionaryEncoding{id, indexType}; indices are int32.
+        FbTable d;
+        fb_table_begin(b, &d);
+        fb_add_field(b, &d, 0, ARROW_SYMBOL_DICTIONARY_ID, sizeof(int64_t));
+        size_t index_type_slot = fb_add_offset(b, &d, 1);
+        fb_table_end(b, &d);
+        fb_patch_offset(b, dictionary_slot, d.start);
+        fb_patch_offset(b, index_type_slot, fb_int_type(b, 32));
+    }
+    fb_patch_offset(b, children_slot, fb_vector_begin(b, 0, sizeof(uint32_t)));
+    return t.start;
+}
+
+static bool host_is_big_endian(void) {
+    const uint16_t probe = 1;
+    return *(const unsigned char *)&probe == 0;
+}
+
+// Schema{endianness, fields}: "Symbol" first, then the file's columns.
+static size_t fb_schema(FbBuilder *b, const FileSchema *schema) {
+    FbTable t;
+    fb_table_begin(b, &t);
+    fb_add_field(b, &t, 0, host_is_big_endian() ? 1 : 0, sizeof(int16_t)); // The .bin is host order
+    size_t fields_slot = fb_add_offset(b, &t, 1);
+    fb_table_end(b, &t);
+
+    size_t num_fields = 1 + schema->field_count;
+    size_t vector = fb_vector_begin(b, num_fields, sizeof(uint32_t));
+    for (size_t i = 0; i < num_fields; ++i) fb_put_le(b, 0, sizeof(uint32_t));
+    fb_patch_offset(b, fields_slot, vector);
+
+    size_t slot = vector + sizeof(uint32_t);
+    fb_patch_offset(b, slot, fb_field(b, "Symbol", ARROW_TYPE_UTF8, true, NULL));
+    for (uint32_t i = 0; i < schema->field_count; ++i) {
+        const FieldDesc *f = &schema->fields[i];
+        uint8_t type_type = f->type == FIELD_TYPE_FLOAT32 ? ARROW_TYPE_FLOATING_POINT : ARROW_TYPE_INT;
+        slot += sizeof(uint32_t);
+        fb_patch_offset(b, slot, fb_field(b, f->name, type_type, false, f));
+    }
+    return t.start;
+}
+
+typedef struct {
+    uint64_t offset;
+    uint64_t length;
+} ArrowBuffer;
+
+// RecordBatch{length, nodes, buffers}. Every column has one FieldNode with no
+// nulls and an empty validity buffer.
+static size_t fb_record_batch(FbBuilder *b, uint64_t length, size_t num_columns,
+                              const ArrowBuffer *buffers, size_t num_buffers) {
+    FbTable t;
+    fb_table_begin(b, &t);
+    fb_add_field(b, &t, 0, length, sizeof(int64_t));
+    size_t nodes_slot = fb_add_offset(b, &t, 1);
+    size_t buffers_slot = fb_add_offset(b, &t, 2);
+    fb_table_end(b, &t);
+
+    size_t nodes = fb_vector_begin(b, num_columns, sizeof(int64_t));
+    for (size_t i = 0; i < num_columns; ++i) {
+        fb_put_le(b, length, sizeof(int64_t)); // length
+        fb_put_le(b, 0, sizeof(int64_t));      // null_count
+    }
+    fb_patch_offset(b, nodes_slot, nodes);
+
+    size_t buffer_vector = fb_vector_begin(b, num_buffers, sizeof(int64_t));
+    for (size_t i = 0; i < num_buffers; ++i) {
+        fb_put_le(b, buffers[i].offset, sizeof(int64_t));
+        fb_put_le(b, buffers[i].length, sizeof(int64_t));
+    }
+    fb_patch_offset(b, buffers_slot, buffer_vector);
+    return t.start;
+}
+
+// Starts a Message{version, header_type, header, bodyLength} as the root of
+// the buffer and returns the slot for the header table.
+static size_t fb_message_begin(FbBuilder *b, uint8_t header_type, uint64_t body_length) {
+    fb_reset(b);
+    fb_put_le(b, 0, sizeof(uint32_t)); // Root offset
+    FbTable t;
+    fb_table_begin(b, &t);
+    fb_add_field(b, &t, 0, ARROW_METADATA_V5, sizeof(int16_t));
+    fb_add_field(b, &t, 1, header_type, sizeof(uint8_t));
+    size_t header_slot = fb_add_offset(b, &t, 2);
+    fb_add_field(b, &t, 3, body_length, sizeof(int64_t));
+    fb_table_end(b, &t);
+    fb_patch_offset(b, 0, t.start);
+    return header_slot;
+}
+
+// --- IPC file writer ---
+
+typedef struct {
+    uint64_t offset;
+    uint32_t metadata_length;
+    uint64_t body_length;
+} ArrowBlock;
+
+typedef struct {
+    FILE *out;
+    uint64_t pos;
+    ArrowBlock *batches;
+    size_t batch_count;
+    ArrowBlock dictionary;
+    bool ok;
+    int32_t index_chunk[1024];  // Pre-filled symbol indices, see write_symbol_indices
+    int32_t index_chunk_value;
+    bool index_chunk_filled;
+} ArrowWriter;
+
+static uint64_t align_up(uint64_t value, uint64_t align) {
+    return (value + align - 1) / align * align;
+}
+
+static void arrow_write(ArrowWriter *w, const void *bytes, size_t n) {
+    if (!w->ok || n == 0) return;
+    if (fwrite(bytes, 1, n, w->out) != n) {
+        perror("❌ Failed to write Arrow file");
+        w->ok = false;
+        return;
+    }
+    w->pos += n;
+}
+
+static void arrow_write_zeros(ArrowWriter *w, uint64_t n) {
+    static const unsigned char zeros[ARROW_ALIGNMENT];
+    while (w->ok && n > 0) {
+        size_t chunk = n < sizeof(zeros) ? (size_t)n : sizeof(zeros);
+        arrow_write(w, zeros, chunk);
+        n -= chunk;
+    }
+}
+
+static void arrow_write_le32(ArrowWriter *w, uint32_t value) {
+    unsigned char bytes[4];
+    for (int i = 0; i < 4; ++i) bytes[i] = (unsigned char)(value >> (8 * i));
+    arrow_write(w, bytes, sizeof(bytes));
+}
+
+// Writes the encapsulated message prefix and metadata, padded so the body
+// that follows starts on an ARROW_ALIGNMENT boundary.
+static void arrow_write_message(ArrowWriter *w, FbBuilder *meta, uint64_t body_length, ArrowBlock *block) {
+    if (meta->failed) w->ok = false;
+    if (!w->ok) return;
+    uint64_t body_start = align_up(w->pos + 8 + meta->len, ARROW_ALIGNMENT);
+    uint64_t padding = body_start - (w->pos + 8 + meta->len);
+    if (block) {
+        block->offset = w->pos;
+        block->metadata_length = (uint32_t)(body_start - w->pos);
+        block->body_length = body_length;
+    }
+    arrow_write_le32(w, 0xFFFFFFFFu); // Continuation marker
+    arrow_write_le32(w, (uint32_t)(meta->len + padding));
+    arrow_write(w, meta->data, meta->len);
+    arrow_write_zeros(w, padding);
+}
+
+// Lays out a buffer at the next aligned body offset.
+static void plan_buffer(ArrowBuffer *buffers, size_t *count, uint64_t *body_length, uint64_t length) {
+    buffers[*count].offset = length > 0 ? align_up(*body_length, ARROW_ALIGNMENT) : *body_length;
+    buffers[*count].length = length;
+    *body_length = buffers[*count].offset + length;
+    (*count)++;
+}
+
+static void write_symbol_dictionary(ArrowWriter *w, FbBuilder *meta, const BinFile *bf) {
+    size_t count = bf->scrip_count;
+    int32_t *offsets = malloc((count + 1) * sizeof(int32_t));
+    if (!offsets) {
+        perror("❌ Failed to allocate symbol dictionary");
+        w->ok = false;
+        return;
+    }
+    offsets[0] = 0;
+    for (size_t i = 0; i < count; ++i) offsets[i + 1] = offsets[i] + bf->scrips[i].name_len;
+
+    ArrowBuffer buffers[3];
+    size_t num_buffers = 0;
+    uint64_t body_length = 0;
+    plan_buffer(buffers, &num_buffers, &body_length, 0);                               // validity
+    plan_buffer(buffers, &num_buffers, &body_length, (count + 1) * sizeof(int32_t)); // offsets
+    plan_buffer(buffers, &num_buffers, &body_length, (uint64_t)offsets[count]);       // characters
+    body_length = align_up(body_length, ARROW_ALIGNMENT);
+
+    // DictionaryBatch{id, data}
+    size_t header_slot = fb_message_begin(meta, ARROW_HEADER_DICTIONARY_BATCH, body_length);
+    FbTable t;
+    fb_table_begin(meta, &t);
+    fb_add_field(meta, &t, 0, ARROW_SYMBOL_DICTIONARY_ID, sizeof(int64_t));
+    size_t data_slot = fb_add_offset(meta, &t, 1);
+    fb_table_end(meta, &t);
+    fb_patch_offset(meta, header_slot, t.start);
+    fb_patch_offset(meta, data_slot, fb_record_batch(meta, count, 1, buffers, num_buffers));
+    arrow_write_message(w, meta, body_length, &w->dictionary);
+
+    uint64_t body_start = w->pos;
+    arrow_write_zeros(w, body_start + buffers[1].offset - w->pos);
+    arrow_write(w, offsets, (count + 1) * sizeof(int32_t));
+    arrow_write_zeros(w, body_start + buffers[2].offset - w->pos);
+    for (size_t i = 0; i < count; ++i) arrow_write(w, bf->scrips[i].name, bf->scrips[i].name_len);
+    arrow_write_zeros(w, body_start + body_length - w->pos);
+    free(offsets);
+}
+
+// Symbol indices are the same for every row of a batch, so they are written
+// from a pre-filled chunk rather than generated value by value.
+static void write_symbol_indices(ArrowWriter *w, int32_t index, size_t rows) {
+    const size_t chunk_len = sizeof(w->index_chunk) / sizeof(w->index_chunk[0]);
+    if (!w->index_chunk_filled || w->index_chunk_value != index) {
+        for (size_t i = 0; i < chunk_len; ++i) w->index_chunk[i] = index;
+        w->index_chunk_value = index;
+        w->index_chunk_filled = true;
+    }
+    while (w->ok && rows > 0) {
+        size_t n = rows < chunk_len ? rows : chunk_len;
+        arrow_write(w, w->index_chunk, n * sizeof(int32_t));
+        rows -= n;
+    }
+}
+
+static void write_scrip_batch(ArrowWriter *w, FbBuilder *meta, const BinFile *bf, size_t scrip_index) {
+    const BinScripEntry *entry = &bf->scrips[scrip_index];
+    const FileSchema *schema = &bf->schema;
+    size_t rows = entry->num_records;
+
+    ArrowBuffer buffers[ARROW_MAX_BUFFERS];
+    size_t num_buffers = 0;
+    uint64_t body_length = 0;
+    plan_buffer(buffers, &num_buffers, &body_length, 0);
+    plan_buffer(buffers, &num_buffers, &body_length, (uint64_t)rows * sizeof(int32_t));
+    for (uint32_t f = 0; f < schema->field_count; ++f) {
+        plan_buffer(buffers, &num_buffers, &body_length, 0);
+        plan_buffer(buffers, &num_buffers, &body_length, (uint64_t)rows * schema->fields[f].width);
+    }
+    body_length = align_up(body_length, ARROW_ALIGNMENT);
+
+    size_t header_slot = fb_message_begin(meta, ARROW_HEADER_RECORD_BATCH, body_length);
+    fb_patch_offset(meta, header_slot, fb_record_batch(meta, rows, 1 + schema->field_count, buffers, num_buffers));
+
+    ArrowBlock *block = &w->batches[w->batch_count++];
+    arrow_write_message(w, meta, body_length, block);
+
+    uint64_t body_start = w->pos;
+    arrow_write_zeros(w, body_start + buffers[1].offset - w->pos);
+    write_symbol_indices(w, (int32_t)scrip_index, rows);
+    for (uint32_t f = 0; f < schema->field_count; ++f) {
+        const ArrowBuffer *data = &buffers[3 + 2 * f];
+        arrow_write_zeros(w, body_start + data->offset - w->pos);
+        arrow_write(w, bin_column(bf, entry, (int)f), (size_t)data->length);
+    }
+    arrow_write_zeros(w, body_start + body_length - w->pos);
+}
+
+static void fb_blocks(FbBuilder *b, size_t slot, const ArrowBlock *blocks, size_t count) {
+    size_t vector = fb_vector_begin(b, count, sizeof(int64_t));
+    for (size_t i = 0; i < count; ++i) {
+        fb_put_le(b, blocks[i].offset, sizeof(int64_t));
+        fb_put_le(b, blocks[i].metadata_length, sizeof(int32_t));
+        fb_put_le(b, 0, sizeof(int32_t)); // Struct padding
+        fb_put_le(b, blocks[i].body_length, sizeof(int64_t));
+    }
+    fb_patch_offset(b, slot, vector);
+}
+
+// Footer{version, schema, dictionaries, recordBatches}, then its size and the magic.
+static void write_footer(ArrowWriter *w, FbBuilder *b, const FileSchema *schema) {
+    fb_reset(b);
+    fb_put_le(b, 0, sizeof(uint32_t));
+    FbTable t;
+    fb_table_begin(b, &t);
+    fb_add_field(b, &t, 0, ARROW_METADATA_V5, sizeof(int16_t));
+    size_t schema_slot = fb_add_offset(b, &t, 1);
+    size_t dictionaries_slot = fb_add_offset(b, &t, 2);
+    size_t batches_slot = fb_add_offset(b, &t, 3);
+    fb_table_end(b, &t);
+    fb_patch_offset(b, 0, t.start);
+    fb_patch_offset(b, schema_slot, fb_schema(b, schema));
+    fb_blocks(b, dictionaries_slot, &w->dictionary, 1);
+    fb_blocks(b, batches_slot, w->batches, w->batch_count);
+    fb_pad_to(b, 8, 0);
+    if (b->failed) {
+        w->ok = false;
+        return;
+    }
+    arrow_write(w, b->data, b->len);
+    arrow_write_le32(w, (uint32_t)b->len);
+    arrow_write(w, ARROW_FILE_MAGIC, sizeof(ARROW_FILE_MAGIC));
+}
+
+bool export_arrow_ipc(const char *bin_path, const char *arrow_path) {
+    BinFile bf;
+    if (!bin_open(bin_path, &bf)) return false;
+    if (bf.scrip_count > INT32_MAX) {
+        fprintf(stderr, "❌ Too many scrips (%zu) for int32 symbol indices\n", bf.scrip_count);
+        bin_close(&bf);
+        return false;
+    }
+
+    ArrowWriter w;
+    memset(&w, 0, sizeof(w));
+    w.ok = true;
+    w.batches = malloc((bf.scrip_count + 1) * sizeof(ArrowBlock));
+    w.out = fopen(arrow_path, "wb");
+    if (!w.batches || !w.out) {
+        perror("❌ Failed to open Arrow output");
+        free(w.batches);
+        if (w.out) fclose(w.out);
+        bin_close(&bf);
+        return false;
+    }
+    FbBuilder meta;
+    fb_init(&meta);
+
+    // Leading magic padded to 8 bytes, then the stream: schema, dictionary, batches, end-of-stream.
+    arrow_write(&w, ARROW_FILE_MAGIC, sizeof(ARROW_FILE_MAGIC));
+    arrow_write_zeros(&w, 2);
+    size_t header_slot = fb_message_begin(&meta, ARROW_HEADER_SCHEMA, 0);
+    fb_patch_offset(&meta, header_slot, fb_schema(&meta, &bf.schema));
+    arrow_write_message(&w, &meta, 0, NULL);
+    write_symbol_dictionary(&w, &meta, &bf);
+
+    size_t skipped = 0;
+    for (size_t s = 0; s < bf.scrip_count && w.ok; ++s) {
+        if (bf.scrips[s].num_records == 0) {
+            fprintf(stderr, "⚠️ Skipping %s: invalid data offsets\n", bf.scrips[s].name);
+            skipped++;
+            continue;
+        }
+        write_scrip_batch(&w, &meta, &bf, s);
+    }
+    arrow_write_le32(&w, 0xFFFFFFFFu);
+    arrow_write_le32(&w, 0);
+    write_footer(&w, &meta, &bf.schema);
+
+    if (fclose(w.out) != 0) {
+        perror("❌ Failed to close Arrow output");
+        w.ok = false;
+    }
+    if (w.ok) {
+        printf("✅ Exported %zu scrips (%zu skipped) to %s, %.2f MB\n",
+               w.batch_count, skipped, arrow_path, (double)w.pos / (1024.0 * 1024.0));
+    }
+    fb_free(&meta);
+    free(w.batches);
+    bin_close(&bf);
+    return w.ok;
+}
@@ -0,0 +1,15 @@
+#ifndef ARROW_EXPORT_H
+#define ARROW_EXPORT_H
+
+#include <stdbool.h>
+
+// --- Apache Arrow IPC file export ---
+// Writes the .bin as one long Arrow table: a dictionary-encoded "Symbol"
+// column followed by every column of the file header, one record batch per
+// scrip. Column buffers are copied straight from the mapped .bin with no
+// per-value conversion, and every buffer starts on a 64-byte boundary so
+// readers can memory-map the result zero-copy. No Arrow library is needed;
+// the small amount of flatbuffer metadata is encoded by hand.
+bool export_arrow_ipc(const char *bin_path, const char *arrow_path);
+
+#endif // ARROW_EXPORT_H
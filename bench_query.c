@@ -0,0 +1,148 @@
+// Load generator for the query daemon: N client threads issue full-history
+// fetches of random scrips and report throughput and client-side latency.
+//
+// Usage: cdo_bench <in.bin> [--socket PATH] [--threads N] [--requests M]
+
+#include "bin_reader.h"
+#include "query_client.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+
+typedef struct {
+    const char *socket_path;
+    const BinFile *bf;
+    size_t requests;
+    unsigned int seed;
+    uint64_t *latencies_ns; // One slot per request, the first completed of them filled
+    size_t completed;       // Requests that got a response
+    uint64_t bytes_received;
+    size_t failures;
+} BenchThread;
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void *bench_thread(void *arg) {
+    BenchThread *bt = arg;
+    QueryClient qc;
+    if (!query_client_connect(&qc, bt->socket_path)) {
+        bt->failures = bt->requests;
+        return NULL;
+    }
+    for (size_t i = 0; i < bt->requests; ++i) {
+        const BinScripEntry *entry = &bt->bf->scrips[rand_r(&bt->seed) % bt->bf->scrip_count];
+        QueryResult result;
+        uint64_t start = monotonic_ns();
+        bool ok = query_client_fetch(&qc, entry->name, INT64_MIN, INT64_MAX, QUERY_ALL_COLUMNS, &result);
+        if (!ok) {
+            bt->failures += bt->requests - i;
+            break;
+        }
+        bt->latencies_ns[bt->completed++] = monotonic_ns() - start;
+        if (result.status != QUERY_STATUS_OK || result.row_count != entry->num_records) bt->failures++;
+        bt->bytes_received += result.payload_bytes;
+        query_result_free(&result);
+    }
+    query_client_close(&qc);
+    return NULL;
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+int main(int argc, char *argv[]) {
+    const char *bin_path = NULL;
+    const char *socket_path = QUERY_DEFAULT_SOCKET_PATH;
+    int num_threads = 4;
+    size_t requests_per_thread = 10000;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) socket_path = argv[++i];
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) num_threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--requests") == 0 && i + 1 < argc) requests_per_thread = strtoull(argv[++i], NULL, 10);
+        else bin_path = argv[i];
+    }
+    if (!bin_path || num_threads <= 0 || requests_per_thread == 0) {
+        fprintf(stderr, "Usage: %s <in.bin> [--socket PATH] [--threads N] [--requests M]\n", argv[0]);
+        return 2;
+    }
+
+    // The .bin is only used for the list of symbols and their expected sizes.
+    BinFile bf;
+    if (!bin_open(bin_path, &bf)) return 1;
+    if (bf.scrip_count == 0) {
+        fprintf(stderr, "❌ No scrips in %s\n", bin_path);
+        bin_close(&bf);
+        return 1;
+    }
+
+    size_t total_requests = (size_t)num_threads * requests_per_thread;
+    BenchThread *threads = calloc((size_t)num_threads, sizeof(BenchThread));
+    pthread_t *tids = calloc((size_t)num_threads, sizeof(pthread_t));
+    uint64_t *latencies = calloc(total_requests, sizeof(uint64_t));
+    if (!threads || !tids || !latencies) {
+        perror("❌ Failed to allocate benchmark state");
+        return 1;
+    }
+
+    uint64_t start = monotonic_ns();
+    int started = 0;
+    for (int t = 0; t < num_threads; ++t, ++started) {
+        threads[t].socket_path = socket_path;
+        threads[t].bf = &bf;
+        threads[t].requests = requests_per_thread;
+        threads[t].seed = 12345u + (unsigned int)t;
+        threads[t].latencies_ns = latencies + (size_t)t * requests_per_thread;
+        if (pthread_create(&tids[t], NULL, bench_thread, &threads[t]) != 0) {
+            perror("❌ Failed to start benchmark thread");
+            break;
+        }
+    }
+    uint64_t bytes = 0;
+    size_t failures = (size_t)(num_threads - started) * requests_per_thread;
+    size_t completed = 0;
+    for (int t = 0; t < started; ++t) {
+        pthread_join(tids[t], NULL);
+        bytes += threads[t].bytes_received;
+        failures += threads[t].failures;
+        // Pack the recorded samples together; unanswered slots hold no latency.
+        memmove(latencies + completed, threads[t].latencies_ns, threads[t].completed * sizeof(uint64_t));
+        completed += threads[t].completed;
+    }
+    double elapsed = (double)(monotonic_ns() - start) / 1e9;
+
+    printf("Requests: %zu in %.3f s (%.0f req/s, %.1f MB/s), failures: %zu\n",
+           completed, elapsed, (double)completed / elapsed,
+           (double)bytes / (1024.0 * 1024.0) / elapsed, failures);
+    if (completed > 0) {
+        qsort(latencies, completed, sizeof(uint64_t), compare_u64);
+        printf("Client latency p50: %.1f us, p99: %.1f us, max: %.1f us\n",
+               (double)latencies[completed / 2] / 1000.0,
+               (double)latencies[(size_t)((double)completed * 0.99)] / 1000.0,
+               (double)latencies[completed - 1] / 1000.0);
+    }
+
+    QueryClient qc;
+    QueryServerStats stats;
+    if (query_client_connect(&qc, socket_path) && query_client_stats(&qc, &stats)) {
+        printf("Server: %llu requests, %llu errors, p50: %.1f us, p99: %.1f us\n",
+               (unsigned long long)stats.requests, (unsigned long long)stats.errors,
+               (double)stats.p50_ns / 1000.0, (double)stats.p99_ns / 1000.0);
+    }
+    query_client_close(&qc);
+
+    free(latencies);
+    free(tids);
+    free(threads);
+    bin_close(&bf);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,379 @@
+#include "bin_reader.h"
+#include "crc32c.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>    // For open
+#include <unistd.h>   // For close
+#include <sys/mman.h> // For mmap
+#include <sys/stat.h> // For fstat
+
+static bool read_directory(FILE *fin, BinFile *bf) {
+    size_t capacity = 256;
+    bf->scrips = malloc(capacity * sizeof(BinScripEntry));
+    if (!bf->scrips) {
+        perror("❌ Failed to allocate scrip directory");
+        return false;
+    }
+
+    long pos = ftell(fin);
+    while (pos != -1L && (uint64_t)pos < bf->end_of_all_headers) {
+        if (bf->scrip_count >= capacity) {
+            capacity *= 2;
+            BinScripEntry *temp = realloc(bf->scrips, capacity * sizeof(BinScripEntry));
+            if (!temp) {
+                perror("❌ Failed to grow scrip directory");
+                return false;
+            }
+            bf->scrips = temp;
+        }
+        BinScripEntry *e = &bf->scrips[bf->scrip_count];
+        uint64_t record_count = 0;
+        if (fread(&e->name_len, sizeof(unsigned char), 1, fin) != 1 ||
+            e->name_len == 0 || e->name_len > 100 ||
+            fread(e->name, sizeof(char), e->name_len, fin) != e->name_len ||
+            fread(&e->data_start, sizeof(uint64_t), 1, fin) != 1 ||
+            fread(&e->data_end, sizeof(uint64_t), 1, fin) != 1 ||
+            (bf->schema.version >= BIN_FORMAT_VERSION_ALIGNED && fread(&record_count, sizeof(uint64_t), 1, fin) != 1) ||
+            (bf->schema.version >= BIN_FORMAT_VERSION_CHECKSUMS && fread(&e->block_crc, sizeof(uint32_t), 1, fin) != 1)) {
+            fprintf(stderr, "❌ Corrupt scrip directory entry %zu at offset %ld\n", bf->scrip_count, pos);
+            return false;
+        }
+        e->name[e->name_len] = '\0';
+        if (bf->schema.version < BIN_FORMAT_VERSION_CHECKSUMS) e->block_crc = 0;
+
+        e->num_records = 0;
+        e->zone_blocks = 0;
+        e->block_end = e->data_end;
+        if (e->data_start >= bf->end_of_all_headers && e->data_start < e->data_end && e->data_end <= bf->size) {
+            uint64_t data_size = e->data_end - e->data_start;
+            if (bf->schema.version < BIN_FORMAT_VERSION_ALIGNED && data_size % bf->schema.record_size == 0) {
+                record_count = data_size / bf->schema.record_size;
+            }
+            if (record_count > 0 && schema_columns_bytes(&bf->schema, record_count) == data_size &&
+                e->data_start + schema_block_bytes(&bf->schema, record_count) <= bf->size) {
+                e->num_records = (size_t)record_count;
+                e->zone_blocks = schema_zone_blocks(&bf->schema, record_count);
+                e->block_end = e->data_start + schema_block_bytes(&bf->schema, record_count);
+            }
+        }
+        bf->scrip_count++;
+        pos = ftell(fin);
+    }
+    if (pos == -1L) {
+        perror("ftell failed while reading scrip directory");
+        return false;
+    }
+    return true;
+}
+
+// C11 qsort has no user-data argument, so entries are sorted as
+// {entry, index} pairs and the indices are copied out afterwards.
+typedef struct {
+    const BinScripEntry *entry;
+    size_t index;
+} ScripRef;
+
+static int compare_scrip_names(const void *a, const void *b) {
+    const ScripRef *ra = a, *rb = b;
+    int c = strcmp(ra->entry->name, rb->entry->name);
+    if (c != 0) return c;
+    return (ra->index > rb->index) - (ra->index < rb->index);
+}
+
+static int compare_data_start(const void *a, const void *b) {
+    const ScripRef *ra = a, *rb = b;
+    if (ra->entry->data_start != rb->entry->data_start) return ra->entry->data_start < rb->entry->data_start ? -1 : 1;
+    return (ra->index > rb->index) - (ra->index < rb->index);
+}
+
+// Fills out_indices with the directory indices of bf ordered by compare.
+static bool sort_scrip_indices(const BinFile *bf, int (*compare)(const void *, const void *), size_t *out_indices) {
+    ScripRef *refs = malloc((bf->scrip_count + 1) * sizeof(ScripRef));
+    if (!refs) return false;
+    for (size_t i = 0; i < bf->scrip_count; ++i) {
+        refs[i].entry = &bf->scrips[i];
+        refs[i].index = i;
+    }
+    qsort(refs, bf->scrip_count, sizeof(ScripRef), compare);
+    for (size_t i = 0; i < bf->scrip_count; ++i) out_indices[i] = refs[i].index;
+    free(refs);
+    return true;
+}
+
+bool bin_open(const char *path, BinFile *out) {
+    memset(out, 0, sizeof(*out));
+
+    FILE *fin = fopen(path, "rb");
+    if (!fin) {
+        perror("❌ Failed to open binary file");
+        return false;
+    }
+    struct stat st;
+    if (fstat(fileno(fin), &st) != 0) {
+        perror("❌ Failed to stat binary file");
+        fclose(fin);
+        return false;
+    }
+    out->size = (size_t)st.st_size;
+
+    if (!read_schema_header(fin, &out->schema) ||
+        fread(&out->end_of_all_headers, sizeof(uint64_t), 1, fin) != 1) {
+        fprintf(stderr, "❌ Failed to read header of %s\n", path);
+        fclose(fin);
+        return false;
+    }
+    if (out->schema.version >= BIN_FORMAT_VERSION_CHECKSUMS) {
+        long crc_pos = ftell(fin);
+        if (crc_pos == -1L || fread(&out->header_crc, sizeof(uint32_t), 1, fin) != 1) {
+            fprintf(stderr, "❌ Failed to read header checksum of %s\n", path);
+            fclose(fin);
+            return false;
+        }
+        out->header_crc_offset = (uint64_t)crc_pos;
+    }
+    if (out->end_of_all_headers > out->size ||
+        (out->schema.version >= BIN_FORMAT_VERSION_CHECKSUMS && out->header_crc_offset + sizeof(uint32_t) > out->end_of_all_headers)) {
+        fprintf(stderr, "❌ End of headers (%llu) is past end of file (%zu) in %s\n",
+                (unsigned long long)out->end_of_all_headers, out->size, path);
+        fclose(fin);
+        return false;
+    }
+    if (!read_directory(fin, out)) {
+        fclose(fin);
+        bin_close(out);
+        return false;
+    }
+
+    void *map = mmap(NULL, out->size, PROT_READ, MAP_SHARED, fileno(fin), 0);
+    fclose(fin); // The mapping stays valid after the descriptor is closed
+    if (map == MAP_FAILED) {
+        perror("❌ Failed to mmap binary file");
+        bin_close(out);
+        return false;
+    }
+    out->base = map;
+
+    if (bin_has_checksums(out)) {
+        // The checksum field itself counts as zero.
+        static const unsigned char zero_crc[sizeof(uint32_t)] = {0};
+        uint64_t after_slot = out->header_crc_offset + sizeof(uint32_t);
+        uint32_t crc = crc32c(0, out->base, (size_t)out->header_crc_offset);
+        crc = crc32c(crc, zero_crc, sizeof(zero_crc));
+        crc = crc32c(crc, out->base + after_slot, (size_t)(out->end_of_all_headers - after_slot));
+        if (crc != out->header_crc) {
+            fprintf(stderr, "❌ Header checksum mismatch in %s (stored %08x, computed %08x)\n", path, out->header_crc, crc);
+            bin_close(out);
+            return false;
+        }
+    }
+
+    out->sorted_by_name = malloc((out->scrip_count + 1) * sizeof(size_t));
+    if (!out->sorted_by_name || !sort_scrip_indices(out, compare_scrip_names, out->sorted_by_name)) {
+        perror("❌ Failed to allocate scrip name index");
+        bin_close(out);
+        return false;
+    }
+    return true;
+}
+
+void bin_close(BinFile *bf) {
+    if (bf->base) munmap((void *)bf->base, bf->size);
+    free(bf->scrips);
+    free(bf->sorted_by_name);
+    free((void *)bf->block_state);
+    memset(bf, 0, sizeof(*bf));
+}
+
+const unsigned char *bin_column(const BinFile *bf, const BinScripEntry *entry, int file_field) {
+    return bf->base + entry->data_start + schema_column_offset(&bf->schema, (uint32_t)file_field, entry->num_records);
+}
+
+const unsigned char *bin_indicator_state(const BinFile *bf, const BinScripEntry *entry) {
+    if (bf->schema.indicator_state_bytes == 0 || entry->num_records == 0) return NULL;
+    return bf->base + entry->data_start + schema_state_offset(&bf->schema, entry->num_records);
+}
+
+static double load_value(const unsigned char *p, const FieldDesc *f) {
+    if (f->type == FIELD_TYPE_FLOAT32) {
+        float v;
+        memcpy(&v, p, sizeof(float));
+        return v;
+    }
+    if (f->width == sizeof(int64_t)) {
+        int64_t v;
+        memcpy(&v, p, sizeof(int64_t));
+        return (double)v;
+    }
+    int32_t v;
+    memcpy(&v, p, sizeof(int32_t));
+    return v;
+}
+
+double bin_value(const BinFile *bf, const BinScripEntry *entry, int field, size_t row) {
+    const FieldDesc *f = &bf->schema.fields[field];
+    return load_value(bin_column(bf, entry, field) + row * f->width, f);
+}
+
+void bin_resolve_predicates(const BinFile *bf, const BinScripEntry *entry, const ScanPredicate *preds,
+                            size_t num_preds, ScanColumn *out_columns) {
+    for (size_t p = 0; p < num_preds; ++p) {
+        out_columns[p].base = bin_column(bf, entry, preds[p].field);
+        out_columns[p].field = &bf->schema.fields[preds[p].field];
+        out_columns[p].min = preds[p].min;
+        out_columns[p].max = preds[p].max;
+    }
+}
+
+bool bin_row_matches(const ScanColumn *columns, size_t num_columns, size_t row) {
+    for (size_t p = 0; p < num_columns; ++p) {
+        const FieldDesc *f = columns[p].field;
+        double v = load_value(columns[p].base + row * f->width, f);
+        if (!(v >= columns[p].min && v <= columns[p].max)) return false; // NaN (indicator warm-up) never matches
+    }
+    return true;
+}
+
+static bool zone_block_may_match(const BinFile *bf, const BinScripEntry *entry, size_t block,
+                                 const ScanPredicate *preds, size_t num_preds) {
+    const unsigned char *summary = bf->base + entry->data_end + block * 2 * bf->schema.record_size;
+    for (size_t p = 0; p < num_preds; ++p) {
+        const FieldDesc *f = &bf->schema.fields[preds[p].field];
+        const unsigned char *range = summary + 2 * bf->schema.field_offset[preds[p].field];
+        double block_min = load_value(range, f);
+        double block_max = load_value(range + f->width, f);
+        if (block_max < preds[p].min || block_min > preds[p].max) return false;
+    }
+    return true;
+}
+
+void bin_scan_blocks(const BinFile *bf, const ScanPredicate *preds, size_t num_preds,
+                     ScanBlockCallback on_block, void *ctx, ScanStats *stats) {
+    ScanStats local;
+    memset(&local, 0, sizeof(local));
+    size_t pred_bytes_per_row = 0;
+    for (size_t p = 0; p < num_preds; ++p) pred_bytes_per_row += bf->schema.fields[preds[p].field].width;
+
+    bool keep_going = true;
+    for (size_t s = 0; s < bf->scrip_count && keep_going; ++s) {
+        const BinScripEntry *entry = &bf->scrips[s];
+        if (entry->num_records == 0) continue;
+        local.bytes_total += (uint64_t)entry->num_records * pred_bytes_per_row;
+
+        if (entry->zone_blocks == 0) {
+            local.blocks_total++;
+            local.blocks_matched++;
+            local.bytes_touched += (uint64_t)entry->num_records * pred_bytes_per_row;
+            keep_going = on_block(bf, s, 0, entry->num_records, ctx);
+            continue;
+        }
+
+        size_t block_bars = bf->schema.zone_block_bars;
+        for (size_t b = 0; b < entry->zone_blocks && keep_going; ++b) {
+            local.blocks_total++;
+            local.bytes_touched += 2 * pred_bytes_per_row;
+            if (!zone_block_may_match(bf, entry, b, preds, num_preds)) continue;
+
+            size_t row_begin = b * block_bars;
+            size_t row_end = row_begin + block_bars < entry->num_records ? row_begin + block_bars : entry->num_records;
+            local.blocks_matched++;
+            local.bytes_touched += (uint64_t)(row_end - row_begin) * pred_bytes_per_row;
+            keep_going = on_block(bf, s, row_begin, row_end, ctx);
+        }
+    }
+    if (stats) *stats = local;
+}
+
+long bin_find_scrip(const BinFile *bf, const char *name) {
+    size_t lo = 0, hi = bf->scrip_count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        size_t idx = bf->sorted_by_name[mid];
+        int cmp = strcmp(bf->scrips[idx].name, name);
+        if (cmp == 0) return (long)idx;
+        if (cmp < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return -1;
+}
+
+bool bin_has_checksums(const BinFile *bf) {
+    return bf->schema.version >= BIN_FORMAT_VERSION_CHECKSUMS;
+}
+
+bool bin_verify_block(const BinFile *bf, size_t scrip_index) {
+    if (!bin_has_checksums(bf)) return true;
+    const BinScripEntry *e = &bf->scrips[scrip_index];
+    if (e->num_records == 0) return false;
+    return crc32c(0, bf->base + e->data_start, (size_t)(e->block_end - e->data_start)) == e->block_crc;
+}
+
+enum { BLOCK_UNCHECKED = 0, BLOCK_GOOD = 1, BLOCK_BAD = 2 };
+
+bool bin_enable_lazy_verify(BinFile *bf) {
+    if (bf->block_state || !bin_has_checksums(bf)) return true;
+    bf->block_state = calloc(bf->scrip_count + 1, sizeof(*bf->block_state));
+    if (!bf->block_state) {
+        perror("❌ Failed to allocate block verification state");
+        return false;
+    }
+    return true;
+}
+
+bool bin_touch_scrip(const BinFile *bf, size_t scrip_index) {
+    if (!bf->block_state) return true;
+    unsigned char state = atomic_load_explicit(&bf->block_state[scrip_index], memory_order_acquire);
+    if (state == BLOCK_UNCHECKED) {
+        // Racing threads may both verify the block; they reach the same answer.
+        state = bin_verify_block(bf, scrip_index) ? BLOCK_GOOD : BLOCK_BAD;
+        unsigned char expected = BLOCK_UNCHECKED;
+        if (atomic_compare_exchange_strong(&bf->block_state[scrip_index], &expected, state) && state == BLOCK_BAD) {
+            fprintf(stderr, "❌ %s: block checksum mismatch, refusing to use it\n", bf->scrips[scrip_index].name);
+        }
+    }
+    return state == BLOCK_GOOD;
+}
+
+size_t bin_check_offsets(const BinFile *bf, FILE *report) {
+    size_t problems = 0;
+
+    for (size_t i = 0; i < bf->scrip_count; ++i) {
+        const BinScripEntry *e = &bf->scrips[i];
+        if (e->data_start < bf->end_of_all_headers || e->block_end > bf->size || e->data_start >= e->data_end) {
+            fprintf(report, "❌ %s: data range [%llu, %llu) outside data section [%llu, %zu)\n",
+                    e->name, (unsigned long long)e->data_start, (unsigned long long)e->data_end,
+                    (unsigned long long)bf->end_of_all_headers, bf->size);
+            problems++;
+        } else if (e->num_records == 0) {
+            fprintf(report, "❌ %s: data size %llu does not match a whole number of %zu-byte records\n",
+                    e->name, (unsigned long long)(e->data_end - e->data_start), bf->schema.record_size);
+            problems++;
+        }
+    }
+
+    for (size_t i = 1; i < bf->scrip_count; ++i) {
+        const BinScripEntry *prev = &bf->scrips[bf->sorted_by_name[i - 1]];
+        const BinScripEntry *cur = &bf->scrips[bf->sorted_by_name[i]];
+        if (strcmp(prev->name, cur->name) == 0) {
+            fprintf(report, "❌ %s: scrip appears more than once in the directory\n", cur->name);
+            problems++;
+        }
+    }
+
+    size_t *by_start = malloc((bf->scrip_count + 1) * sizeof(size_t));
+    if (!by_start || !sort_scrip_indices(bf, compare_data_start, by_start)) {
+        perror("❌ Failed to allocate offset index");
+        free(by_start);
+        return problems + 1;
+    }
+    for (size_t i = 1; i < bf->scrip_count; ++i) {
+        const BinScripEntry *prev = &bf->scrips[by_start[i - 1]];
+        const BinScripEntry *cur = &bf->scrips[by_start[i]];
+        if (cur->data_start < prev->block_end && prev->data_start < prev->data_end) {
+            fprintf(report, "❌ %s: data range overlaps %s\n", cur->name, prev->name);
+            problems++;
+        }
+    }
+    free(by_start);
+    return problems;
+}
@@ -0,0 +1,111 @@
+#ifndef BIN_READER_H
+#define BIN_READER_H
+
+#include "schema.h" // For FileSchema
+#include <stdio.h>  // For FILE*
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+// --- Memory-mapped reader for .bin files ---
+// The header and scrip directory are parsed once; column data is accessed in
+// place through the mapping. Columns of v5+ files start on
+// schema.column_alignment boundaries; older files are packed, so generic code
+// should still go through memcpy for typed access.
+
+typedef struct {
+    char name[101];
+    unsigned char name_len;
+    uint64_t data_start;
+    uint64_t data_end;    // End of the columns; the zone map (v4+) follows
+    uint64_t block_end;   // End of the columns plus zone map and padding
+    size_t num_records;   // 0 when the offsets are invalid
+    size_t zone_blocks;   // Number of zone map summaries, 0 if none
+    uint32_t block_crc;   // CRC32C of [data_start, block_end), v6+
+} BinScripEntry;
+
+typedef struct {
+    const unsigned char *base;
+    size_t size;
+    FileSchema schema;
+    uint64_t end_of_all_headers;
+    BinScripEntry *scrips;
+    size_t scrip_count;
+    size_t *sorted_by_name; // Indices into scrips, for bin_find_scrip
+    uint32_t header_crc;
+    uint64_t header_crc_offset;
+    _Atomic unsigned char *block_state; // Per scrip, set by bin_enable_lazy_verify
+} BinFile;
+
+// For v6+ files the header checksum is verified here, so a corrupt directory
+// is rejected before any offset is trusted. Blocks are not read.
+bool bin_open(const char *path, BinFile *out);
+void bin_close(BinFile *bf);
+
+// Start of column `file_field` (an index into bf->schema.fields) for a scrip.
+const unsigned char *bin_column(const BinFile *bf, const BinScripEntry *entry, int file_field);
+// Rolling indicator state at the end of a scrip's block (v7+, see schema.h),
+// or NULL when the file has no indicators.
+const unsigned char *bin_indicator_state(const BinFile *bf, const BinScripEntry *entry);
+// Index of the scrip with the given name, or -1.
+long bin_find_scrip(const BinFile *bf, const char *name);
+
+// --- Zone map scans ---
+// A predicate keeps rows whose value of file field `field` lies in [min, max].
+// Predicates are ANDed. Values are compared as doubles whatever the field type.
+typedef struct {
+    int field;
+    double min;
+    double max;
+} ScanPredicate;
+
+typedef struct {
+    size_t blocks_total;
+    size_t blocks_matched;  // Blocks whose summaries could satisfy every predicate
+    uint64_t bytes_total;   // Column bytes of the predicate fields across all blocks
+    uint64_t bytes_touched; // Zone map bytes read plus column bytes of matched blocks
+} ScanStats;
+
+// Called for each candidate block; rows [row_begin, row_end) of the scrip may
+// match and must still be checked row by row. Return false to stop the scan.
+typedef bool (*ScanBlockCallback)(const BinFile *bf, size_t scrip_index, size_t row_begin, size_t row_end, void *ctx);
+
+// Value of file field `field` at `row` of a scrip, widened to double.
+double bin_value(const BinFile *bf, const BinScripEntry *entry, int field, size_t row);
+// A predicate with its column resolved for one scrip, so rows are indexed
+// directly instead of recomputing the column offset for every value.
+typedef struct {
+    const unsigned char *base;
+    const FieldDesc *field;
+    double min;
+    double max;
+} ScanColumn;
+
+// Resolves the predicates against one scrip; call once per scrip, not per row.
+void bin_resolve_predicates(const BinFile *bf, const BinScripEntry *entry, const ScanPredicate *preds,
+                            size_t num_preds, ScanColumn *out_columns);
+bool bin_row_matches(const ScanColumn *columns, size_t num_columns, size_t row);
+// Evaluates the predicates against the zone maps of every scrip and hands only
+// the blocks that may match to on_block. Scrips without zone maps are passed
+// through as a single block. stats may be NULL.
+void bin_scan_blocks(const BinFile *bf, const ScanPredicate *preds, size_t num_preds,
+                     ScanBlockCallback on_block, void *ctx, ScanStats *stats);
+
+// --- Block checksums (v6+) ---
+bool bin_has_checksums(const BinFile *bf);
+// Recomputes a scrip's block checksum. False on mismatch or unusable offsets;
+// always true for files without checksums.
+bool bin_verify_block(const BinFile *bf, size_t scrip_index);
+// Opt-in lazy verification: from now on bin_touch_scrip checks each block the
+// first time it is touched and remembers the result. Thread-safe afterwards.
+bool bin_enable_lazy_verify(BinFile *bf);
+// Call before reading a scrip's columns. Returns false (and reports once) if
+// the block failed verification; always true when lazy verification is off.
+bool bin_touch_scrip(const BinFile *bf, size_t scrip_index);
+
+// Reports offsets outside the data section, overlapping blocks, sizes that do
+// not match a whole number of records and duplicate names. Returns the problem count.
+size_t bin_check_offsets(const BinFile *bf, FILE *report);
+
+#endif // BIN_READER_H
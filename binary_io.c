@@ -1,23 +1,193 @@
 #include "binary_io.h"
 #include "data_structures.h" // Already included, but good for clarity
+#include "schema.h"          // For the field list and format header
 #include "utils.h"           // For LOG_ENABLED
+#include "bin_reader.h"      // For converting older files
+#include "crc32c.h"          // For block and header checksums
+#include "indicators.h"      // For update_scrip_indicators
+#include "zip_parser.h"      // For extending a file with new bars
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>          // For uint64_t
+#include <inttypes.h>        // For PRId64
+#include <sys/stat.h>        // For stat
+#include <math.h>            // For NAN, isnan
+
+// Every byte of a scrip block goes through here so its checksum is computed
+// while the data streams out.
+static bool write_block_bytes(FILE *fout, const void *data, size_t bytes, uint32_t *crc) {
+    if (fwrite(data, 1, bytes, fout) != bytes) return false;
+    *crc = crc32c(*crc, data, bytes);
+    return true;
+}
+
+static bool write_zeros(FILE *fout, size_t bytes, uint32_t *crc) {
+    static const unsigned char zeros[1024] = {0};
+    while (bytes > 0) {
+        size_t chunk = bytes < sizeof(zeros) ? bytes : sizeof(zeros);
+        if (!write_block_bytes(fout, zeros, chunk, crc)) return false;
+        bytes -= chunk;
+    }
+    return true;
+}
+
+// Zero-pads a section of `bytes` bytes up to the next column boundary.
+static bool write_column_padding(FILE *fout, size_t bytes, uint32_t *crc) {
+    size_t padded = (bytes + BIN_COLUMN_ALIGNMENT - 1) / BIN_COLUMN_ALIGNMENT * BIN_COLUMN_ALIGNMENT;
+    return write_zeros(fout, padded - bytes, crc);
+}
+
+// Writes one padded column of a scrip. Columns absent from the source JSON are
+// zero-filled so every scrip carries the full field list from the header.
+static bool write_column(FILE *fout, const void *data, size_t available, size_t width, size_t count, uint32_t *crc) {
+    if (available > 0) {
+        if (!write_block_bytes(fout, data, count * width, crc)) return false;
+    } else if (!write_zeros(fout, count * width, crc)) {
+        return false;
+    }
+    return write_column_padding(fout, count * width, crc);
+}
+
+// Min/max of rows [begin, end) of a column; absent columns were zero-filled.
+#define DEFINE_COLUMN_RANGE(func_name, array_type, value_type)                                   \
+    static void func_name(const array_type *arr, size_t begin, size_t end,                       \
+                          value_type *out_min, value_type *out_max) {                            \
+        if (arr->count == 0) { *out_min = 0; *out_max = 0; return; }                             \
+        value_type mn = arr->data[begin], mx = arr->data[begin];                                 \
+        for (size_t i = begin + 1; i < end; ++i) {                                               \
+            value_type v = arr->data[i];                                                         \
+            if (v < mn) mn = v;                                                                  \
+            if (v > mx) mx = v;                                                                  \
+        }                                                                                        \
+        *out_min = mn;                                                                           \
+        *out_max = mx;                                                                           \
+    }
+DEFINE_COLUMN_RANGE(float_column_range, FloatArray, float)
+DEFINE_COLUMN_RANGE(long_column_range, LongArray, int64_t)
+#undef DEFINE_COLUMN_RANGE
+
+// Indicator columns start with NaN warm-up bars, which must not poison the
+// range; a block of only NaNs summarizes as NaN and is never pruned.
+static void indicator_column_range(const FloatArray *arr, size_t begin, size_t end, float *out_min, float *out_max) {
+    if (arr->count == 0) { *out_min = 0; *out_max = 0; return; }
+    float mn = NAN, mx = NAN;
+    for (size_t i = begin; i < end; ++i) {
+        float v = arr->data[i];
+        if (isnan(v)) continue;
+        if (isnan(mn) || v < mn) mn = v;
+        if (isnan(mx) || v > mx) mx = v;
+    }
+    *out_min = mn;
+    *out_max = mx;
+}
+
+// One min/max summary per ZONE_MAP_BLOCK_BARS rows, fields in on-disk order,
+// padded to a column boundary so the next scrip block stays aligned.
+static bool write_zone_map(FILE *fout, const FileSchema *layout, const ScripInfo *scrip, uint32_t *crc) {
+    size_t n = scrip->expected_count;
+    size_t summaries = 0;
+    for (size_t begin = 0; begin < n; begin += ZONE_MAP_BLOCK_BARS) {
+        size_t end = n - begin > ZONE_MAP_BLOCK_BARS ? begin + ZONE_MAP_BLOCK_BARS : n;
+#define X(id, key, name)                                                                            \
+        {                                                                                           \
+            float range[2];                                                                         \
+            float_column_range(&scrip->float_data_arrays[FLOAT_FIELD_##id], begin, end, &range[0], &range[1]); \
+            if (!write_block_bytes(fout, range, sizeof(range), crc)) return false;                  \
+        }
+        SCRIP_FLOAT_FIELDS(X)
+#undef X
+#define X(id, key, name)                                                                            \
+        {                                                                                           \
+            int64_t range[2];                                                                       \
+            long_column_range(&scrip->long_data_arrays[LONG_FIELD_##id], begin, end, &range[0], &range[1]); \
+            if (!write_block_bytes(fout, range, sizeof(range), crc)) return false;                  \
+        }
+        SCRIP_LONG_FIELDS(X)
+#undef X
+        for (uint32_t c = 0; c < layout->field_count - layout->first_indicator_field; ++c) {
+            float range[2];
+            indicator_column_range(&scrip->indicator_data_arrays[c], begin, end, &range[0], &range[1]);
+            if (!write_block_bytes(fout, range, sizeof(range), crc)) return false;
+        }
+        summaries++;
+    }
+    return write_column_padding(fout, summaries * 2 * layout->record_size, crc);
+}
 
-bool write_binary_two_pass(const char *output_filename, ScripInfoArray *all_scrips_info) {
-    FILE *fout = fopen(output_filename, "wb");
+bool write_scrip_block(FILE *fout, const FileSchema *layout, const ScripInfo *scrip, uint32_t *out_crc) {
+    uint32_t crc = 0;
+#define X(id, key, name)                                                                   \
+    if (!write_column(fout, scrip->float_data_arrays[FLOAT_FIELD_##id].data,               \
+                      scrip->float_data_arrays[FLOAT_FIELD_##id].count, sizeof(float),     \
+                      scrip->expected_count, &crc)) return false;
+    SCRIP_FLOAT_FIELDS(X)
+#undef X
+#define X(id, key, name)                                                                   \
+    if (!write_column(fout, scrip->long_data_arrays[LONG_FIELD_##id].data,                 \
+                      scrip->long_data_arrays[LONG_FIELD_##id].count, sizeof(int64_t),     \
+                      scrip->expected_count, &crc)) return false;
+    SCRIP_LONG_FIELDS(X)
+#undef X
+    for (uint32_t c = 0; c < layout->field_count - layout->first_indicator_field; ++c) {
+        if (!write_column(fout, scrip->indicator_data_arrays[c].data, scrip->indicator_data_arrays[c].count,
+                          sizeof(float), scrip->expected_count, &crc)) return false;
+    }
+    if (!write_zone_map(fout, layout, scrip, &crc)) return false;
+    // Rolling indicator state, so the scrip can later be extended without its history.
+    if (layout->indicator_state_bytes > 0) {
+        if (scrip->indicator_state_len * sizeof(double) == layout->indicator_state_bytes) {
+            if (!write_block_bytes(fout, scrip->indicator_state, layout->indicator_state_bytes, &crc)) return false;
+        } else if (!write_zeros(fout, layout->indicator_state_bytes, &crc)) {
+            return false;
+        }
+        if (!write_column_padding(fout, layout->indicator_state_bytes, &crc)) return false;
+    }
+    *out_crc = crc;
+    return true;
+}
+
+// The directory is patched as blocks are written, so the header checksum is
+// computed last by reading the (small) header section back.
+static bool write_header_checksum(FILE *fout, uint64_t end_of_all_headers, long crc_slot) {
+    unsigned char buffer[4096];
+    uint32_t crc = 0;
+    if (fflush(fout) != 0 || fseek(fout, 0, SEEK_SET) != 0) return false;
+    for (uint64_t remaining = end_of_all_headers; remaining > 0;) {
+        size_t chunk = remaining < sizeof(buffer) ? (size_t)remaining : sizeof(buffer);
+        if (fread(buffer, 1, chunk, fout) != chunk) return false;
+        crc = crc32c(crc, buffer, chunk); // The slot still holds zero here
+        remaining -= chunk;
+    }
+    if (fseek(fout, crc_slot, SEEK_SET) != 0) return false;
+    return fwrite(&crc, sizeof(uint32_t), 1, fout) == 1;
+}
+
+bool write_binary_two_pass(const char *output_filename, const FileSchema *layout, ScripInfoArray *all_scrips_info, SpillStore *spill) {
+    FILE *fout = fopen(output_filename, "w+b");
     if (!fout) {
         perror("❌ Failed to open binary output file for writing");
         return false;
     }
 
+    if (!write_schema_header(fout, layout)) {
+        fclose(fout); return false;
+    }
+
+    long end_of_all_headers_ptr_long = ftell(fout);
+    if (end_of_all_headers_ptr_long == -1L) { perror("ftell failed before end_of_all_headers"); fclose(fout); return false; }
+
     uint64_t placeholder_end_of_all_headers = 0;
     if (fwrite(&placeholder_end_of_all_headers, sizeof(uint64_t), 1, fout) != 1) {
         perror("❌ Failed to write placeholder for end_of_all_headers");
         fclose(fout); return false;
     }
+    long header_crc_ptr_long = ftell(fout);
+    uint32_t placeholder_crc = 0;
+    if (header_crc_ptr_long == -1L || fwrite(&placeholder_crc, sizeof(uint32_t), 1, fout) != 1) {
+        perror("❌ Failed to write placeholder for header checksum");
+        fclose(fout); return false;
+    }
 
     for (size_t i = 0; i < all_scrips_info->count; ++i) {
         ScripInfo *scrip = &all_scrips_info->scrips[i];
@@ -44,14 +214,22 @@ bool write_binary_two_pass(const char *output_filename, ScripInfoArray *all_scri
         if (fwrite(&placeholder_data_addr, sizeof(uint64_t), 1, fout) != 1) {
             perror("❌ Failed to write placeholder for data_end_offset"); fclose(fout); return false;
         }
+
+        uint64_t record_count = scrip->expected_count;
+        if (fwrite(&record_count, sizeof(uint64_t), 1, fout) != 1) {
+            perror("❌ Failed to write record count"); fclose(fout); return false;
+        }
+        if (fwrite(&placeholder_crc, sizeof(uint32_t), 1, fout) != 1) {
+            perror("❌ Failed to write placeholder for block checksum"); fclose(fout); return false;
+        }
     }
 
     long actual_end_of_all_headers_long = ftell(fout);
     if (actual_end_of_all_headers_long == -1L) { perror("ftell failed for actual_end_of_all_headers"); fclose(fout); return false; }
     uint64_t actual_end_of_all_headers = (uint64_t)actual_end_of_all_headers_long;
 
-    if (fseek(fout, 0, SEEK_SET) != 0) {
-        perror("❌ Failed to seek to beginning to write end_of_all_headers"); fclose(fout); return false;
+    if (fseek(fout, end_of_all_headers_ptr_long, SEEK_SET) != 0) {
+        perror("❌ Failed to seek back to write end_of_all_headers"); fclose(fout); return false;
     }
     if (fwrite(&actual_end_of_all_headers, sizeof(uint64_t), 1, fout) != 1) {
         perror("❌ Failed to write actual end_of_all_headers"); fclose(fout); return false;
@@ -60,6 +238,11 @@ bool write_binary_two_pass(const char *output_filename, ScripInfoArray *all_scri
     if (fseek(fout, (long)actual_end_of_all_headers, SEEK_SET) != 0) {
         perror("❌ Failed to seek to start of data section"); fclose(fout); return false;
     }
+    // Every block is padded to a column boundary, so aligning the first one aligns them all.
+    uint32_t padding_crc = 0; // Padding between the directory and the first block is not covered
+    if (!write_zeros(fout, schema_align(layout, actual_end_of_all_headers) - actual_end_of_all_headers, &padding_crc)) {
+        perror("❌ Failed to pad start of data section"); fclose(fout); return false;
+    }
 
     for (size_t i = 0; i < all_scrips_info->count; ++i) {
         ScripInfo *scrip = &all_scrips_info->scrips[i];
@@ -69,26 +252,19 @@ bool write_binary_two_pass(const char *output_filename, ScripInfoArray *all_scri
         if (data_start_offset_long == -1L) { perror("ftell failed before writing data"); fclose(fout); return false; }
         uint64_t actual_data_start_offset = (uint64_t)data_start_offset_long;
 
-        for (int k = 0; k < NUM_FLOAT_KEYS_CONST; ++k) {
-            if (scrip->float_data_arrays[k].count > 0) {
-                if (fwrite(scrip->float_data_arrays[k].data, sizeof(float), scrip->expected_count, fout) != scrip->expected_count) {
-                    perror("❌ Failed to write float data"); fclose(fout); return false;
-                }
-            }
-        }
-        for (int k = 0; k < NUM_LONG_KEYS_CONST; ++k) {
-            if (scrip->long_data_arrays[k].count > 0) {
-                if (fwrite(scrip->long_data_arrays[k].data, sizeof(long int), scrip->expected_count, fout) != scrip->expected_count) {
-                    perror("❌ Failed to write long data"); fclose(fout); return false;
-                }
-            }
+        uint32_t block_crc;
+        if (scrip->is_spilled) {
+            if (!copy_spilled_scrip_block(spill, scrip, fout)) { fclose(fout); return false; }
+            block_crc = scrip->spill_crc;
+        } else if (!write_scrip_block(fout, layout, scrip, &block_crc)) {
+            perror("❌ Failed to write scrip data"); fclose(fout); return false;
         }
 
-        long data_end_offset_long = ftell(fout);
-        if (data_end_offset_long == -1L) { perror("ftell failed after writing data"); fclose(fout); return false; }
-        uint64_t actual_data_end_offset = (uint64_t)data_end_offset_long;
+        // The zone map follows the columns; data_end marks where the columns stop.
+        uint64_t actual_data_end_offset = actual_data_start_offset + schema_columns_bytes(layout, scrip->expected_count);
 
-        long current_pos_after_data_write = data_end_offset_long;
+        long current_pos_after_data_write = ftell(fout);
+        if (current_pos_after_data_write == -1L) { perror("ftell failed after writing data"); fclose(fout); return false; }
 
         if (fseek(fout, (long)scrip->file_offset_for_data_start_ptr, SEEK_SET) != 0) {
             perror("❌ Failed to seek to update data_start_offset"); fclose(fout); return false;
@@ -103,6 +279,11 @@ bool write_binary_two_pass(const char *output_filename, ScripInfoArray *all_scri
         if (fwrite(&actual_data_end_offset, sizeof(uint64_t), 1, fout) != 1) {
             perror("❌ Failed to write actual_data_end_offset"); fclose(fout); return false;
         }
+        // The block checksum slot follows data_end and the record count.
+        if (fseek(fout, (long)(scrip->file_offset_for_data_end_ptr + 2 * sizeof(uint64_t)), SEEK_SET) != 0 ||
+            fwrite(&block_crc, sizeof(uint32_t), 1, fout) != 1) {
+            perror("❌ Failed to write block checksum"); fclose(fout); return false;
+        }
 
         if (fseek(fout, current_pos_after_data_write, SEEK_SET) != 0) {
             perror("❌ Failed to seek back to end of data section"); fclose(fout); return false;
@@ -115,8 +296,11 @@ bool write_binary_two_pass(const char *output_filename, ScripInfoArray *all_scri
         }
     }
 
-    if (fflush(fout) != 0) perror("❌ Failed to flush binary output file");
     long file_size_bytes = ftell(fout);
+    if (!write_header_checksum(fout, actual_end_of_all_headers, header_crc_ptr_long)) {
+        perror("❌ Failed to write header checksum"); fclose(fout); return false;
+    }
+    if (fflush(fout) != 0) perror("❌ Failed to flush binary output file");
     if (file_size_bytes == -1L) {
         perror("❌ Failed to get final binary file size (ftell)");
     } else {
@@ -138,6 +322,33 @@ void read_and_print_binary_data_to_file(const char *input_filename, FILE *outfil
         return;
     }
 
+    FileSchema schema;
+    if (!read_schema_header(fin, &schema)) {
+        fprintf(outfile, "❌ Failed to read format header from binary file: %s\n", input_filename);
+        fclose(fin);
+        return;
+    }
+
+    // Map every compiled field onto its column in the file. Fields the file does
+    // not have are printed as zero; extra file columns are skipped.
+    int file_column[TOTAL_KEYS_CONST];
+    for (int i = 0; i < TOTAL_KEYS_CONST; ++i) {
+        const FieldDesc *want = &COMPILED_SCHEMA_FIELDS[i];
+        file_column[i] = find_schema_field(&schema, want->key);
+        if (file_column[i] < 0) {
+            fprintf(outfile, "ℹ️ Field %s not present in %s, printing zeros.\n", want->name, input_filename);
+            continue;
+        }
+        const FieldDesc *have = &schema.fields[file_column[i]];
+        if (have->type != want->type || have->width != want->width) {
+            fprintf(stderr, "❌ Field %s in %s has type %u / width %u, expected %u / %u\n",
+                    want->name, input_filename, have->type, have->width, want->type, want->width);
+            fprintf(outfile, "❌ Field %s has an incompatible type or width in %s\n", want->name, input_filename);
+            fclose(fin);
+            return;
+        }
+    }
+
     uint64_t end_of_all_headers_offset;
     if (fread(&end_of_all_headers_offset, sizeof(uint64_t), 1, fin) != 1) {
         perror("❌ Failed to read end_of_all_headers_offset from binary file");
@@ -145,9 +356,25 @@ void read_and_print_binary_data_to_file(const char *input_filename, FILE *outfil
         fclose(fin);
         return;
     }
+    uint32_t header_crc; // Checked by `cdo check` and bin_open; the dump only skips it
+    if (schema.version >= BIN_FORMAT_VERSION_CHECKSUMS && fread(&header_crc, sizeof(uint32_t), 1, fin) != 1) {
+        perror("❌ Failed to read header checksum from binary file");
+        fprintf(outfile, "❌ Failed to read header checksum from binary file: %s\n", input_filename);
+        fclose(fin);
+        return;
+    }
 
     fprintf(outfile, "Binary File: %s\n", input_filename);
-    fprintf(outfile, "End of Headers at offset: %llu\n\n", (unsigned long long)end_of_all_headers_offset);
+    fprintf(outfile, "Format version: %u, Fields: %u\n", schema.version, schema.field_count);
+    fprintf(outfile, "End of Headers at offset: %llu\n", (unsigned long long)end_of_all_headers_offset);
+    // Indicator column k is selected by query column mask bit TOTAL_KEYS_CONST + k.
+    uint32_t first_indicator = schema.indicator_count > 0 ? schema.first_indicator_field : schema.field_count;
+    for (uint32_t f = first_indicator; f < schema.field_count; ++f) {
+        uint32_t k = f - first_indicator;
+        fprintf(outfile, "Indicator column %u: %s (key %s, query column bit %u)\n",
+                k, schema.fields[f].name, schema.fields[f].key, (unsigned)TOTAL_KEYS_CONST + k);
+    }
+    fprintf(outfile, "\n");
 
     long current_header_pos = ftell(fin);
      if (current_header_pos == -1L) {
@@ -157,18 +384,17 @@ void read_and_print_binary_data_to_file(const char *input_filename, FILE *outfil
         return;
     }
 
-
-    const char *float_key_names[NUM_FLOAT_KEYS_CONST] = {"Open", "High", "Low", "Close"};
-    const char *long_key_names[NUM_LONG_KEYS_CONST] = {"Timestamp", "Volume"};
-
     while (current_header_pos < (long)end_of_all_headers_offset && !feof(fin)) {
         unsigned char scrip_name_len;
         char scrip_name[101];
         uint64_t data_start_offset;
         uint64_t data_end_offset;
+        uint64_t record_count = 0;
+        uint32_t block_crc;
 
+        unsigned char *block = NULL;
         float* temp_float_data[NUM_FLOAT_KEYS_CONST] = {NULL};
-        long int* temp_long_data[NUM_LONG_KEYS_CONST] = {NULL};
+        int64_t* temp_long_data[NUM_LONG_KEYS_CONST] = {NULL};
         bool scrip_read_success = false;
         size_t num_records = 0;
 
@@ -203,6 +429,16 @@ void read_and_print_binary_data_to_file(const char *input_filename, FILE *outfil
             fprintf(outfile, "❌ Failed to read data_end_offset for scrip %s in %s\n", scrip_name, input_filename);
             goto next_scrip_or_exit;
         }
+        if (schema.version >= BIN_FORMAT_VERSION_ALIGNED && fread(&record_count, sizeof(uint64_t), 1, fin) != 1) {
+            perror("❌ Failed to read record_count");
+            fprintf(outfile, "❌ Failed to read record_count for scrip %s in %s\n", scrip_name, input_filename);
+            goto next_scrip_or_exit;
+        }
+        if (schema.version >= BIN_FORMAT_VERSION_CHECKSUMS && fread(&block_crc, sizeof(uint32_t), 1, fin) != 1) {
+            perror("❌ Failed to read block_crc");
+            fprintf(outfile, "❌ Failed to read block_crc for scrip %s in %s\n", scrip_name, input_filename);
+            goto next_scrip_or_exit;
+        }
 
         fprintf(outfile, "--- Scrip: %s ---\n", scrip_name);
         fprintf(outfile, "  Data Start: %llu, Data End: %llu\n", (unsigned long long)data_start_offset, (unsigned long long)data_end_offset);
@@ -215,21 +451,34 @@ void read_and_print_binary_data_to_file(const char *input_filename, FILE *outfil
         }
 
         size_t total_data_size = data_end_offset - data_start_offset;
-        size_t size_of_one_record_set = (NUM_FLOAT_KEYS_CONST * sizeof(float)) + (NUM_LONG_KEYS_CONST * sizeof(long int));
+        size_t size_of_one_record_set = schema.record_size;
 
-        if (size_of_one_record_set == 0) {
-             fprintf(stderr, "Error: size_of_one_record_set is zero for scrip %s.\n", scrip_name);
-             fprintf(outfile, "Error: size_of_one_record_set is zero for scrip %s.\n", scrip_name);
-             goto cleanup_current_scrip_data;
+        long next_header_entry_pos = ftell(fin);
+         if (next_header_entry_pos == -1L) {
+            perror("ftell error before data seek");
+            fprintf(outfile, "ftell error before data seek for scrip %s\n", scrip_name);
+            goto cleanup_current_scrip_data;
         }
-        if (total_data_size % size_of_one_record_set != 0) {
+
+        if (schema.version >= BIN_FORMAT_VERSION_ALIGNED) {
+            // Padded columns: the directory carries the count, the size must agree with it.
+            if (schema_columns_bytes(&schema, record_count) != total_data_size) {
+                fprintf(stderr, "❌ Data size mismatch for scrip %s. Total %zu does not hold %llu padded records.\n",
+                        scrip_name, total_data_size, (unsigned long long)record_count);
+                fprintf(outfile, "❌ Data size mismatch for scrip %s. Total %zu does not hold %llu padded records.\n",
+                        scrip_name, total_data_size, (unsigned long long)record_count);
+                goto cleanup_current_scrip_data;
+            }
+            num_records = (size_t)record_count;
+        } else if (total_data_size % size_of_one_record_set != 0) {
             fprintf(stderr, "❌ Data size mismatch for scrip %s. Total %zu not multiple of record set size %zu.\n",
                     scrip_name, total_data_size, size_of_one_record_set);
             fprintf(outfile, "❌ Data size mismatch for scrip %s. Total %zu not multiple of record set size %zu.\n",
                     scrip_name, total_data_size, size_of_one_record_set);
             goto cleanup_current_scrip_data;
+        } else {
+            num_records = total_data_size / size_of_one_record_set;
         }
-        num_records = total_data_size / size_of_one_record_set;
         fprintf(outfile, "  Number of records: %zu\n", num_records);
 
         if (num_records == 0) {
@@ -237,68 +486,78 @@ void read_and_print_binary_data_to_file(const char *input_filename, FILE *outfil
             goto cleanup_current_scrip_data;
         }
 
-        long next_header_entry_pos = ftell(fin);
-         if (next_header_entry_pos == -1L) {
-            perror("ftell error before data seek");
-            fprintf(outfile, "ftell error before data seek for scrip %s\n", scrip_name);
-            goto cleanup_current_scrip_data;
-        }
-
-
         if (fseek(fin, (long)data_start_offset, SEEK_SET) != 0) {
             perror("❌ Failed to seek to data_start_offset");
             fprintf(outfile, "❌ Failed to seek to data_start_offset for scrip %s\n", scrip_name);
             goto cleanup_current_scrip_data;
         }
 
-        for (int i = 0; i < NUM_FLOAT_KEYS_CONST; ++i) {
-            temp_float_data[i] = malloc(num_records * sizeof(float));
-            if (!temp_float_data[i]) {
-                fprintf(stderr, "❌ Failed to allocate memory for %s data for scrip %s\n", float_key_names[i], scrip_name);
-                fprintf(outfile, "❌ Failed to allocate memory for %s data for scrip %s\n", float_key_names[i], scrip_name);
-                goto cleanup_current_scrip_data;
-            }
-            if (fread(temp_float_data[i], sizeof(float), num_records, fin) != num_records) {
-                fprintf(stderr, "❌ Failed to read %s data for scrip %s\n", float_key_names[i], scrip_name);
-                fprintf(outfile, "❌ Failed to read %s data for scrip %s\n", float_key_names[i], scrip_name);
-                goto cleanup_current_scrip_data;
-            }
+        // One read for the whole scrip block, then split it into typed columns.
+        block = malloc(total_data_size);
+        if (!block) {
+            fprintf(stderr, "❌ Failed to allocate memory for data block of scrip %s\n", scrip_name);
+            fprintf(outfile, "❌ Failed to allocate memory for data block of scrip %s\n", scrip_name);
+            goto cleanup_current_scrip_data;
+        }
+        if (fread(block, 1, total_data_size, fin) != total_data_size) {
+            fprintf(stderr, "❌ Failed to read data block for scrip %s\n", scrip_name);
+            fprintf(outfile, "❌ Failed to read data block for scrip %s\n", scrip_name);
+            goto cleanup_current_scrip_data;
         }
 
-        for (int i = 0; i < NUM_LONG_KEYS_CONST; ++i) {
-            temp_long_data[i] = malloc(num_records * sizeof(long int));
-            if (!temp_long_data[i]) {
-                fprintf(stderr, "❌ Failed to allocate memory for %s data for scrip %s\n", long_key_names[i], scrip_name);
-                fprintf(outfile, "❌ Failed to allocate memory for %s data for scrip %s\n", long_key_names[i], scrip_name);
-                goto cleanup_current_scrip_data;
-            }
-            if (fread(temp_long_data[i], sizeof(long int), num_records, fin) != num_records) {
-                fprintf(stderr, "❌ Failed to read %s data for scrip %s\n", long_key_names[i], scrip_name);
-                fprintf(outfile, "❌ Failed to read %s data for scrip %s\n", long_key_names[i], scrip_name);
-                goto cleanup_current_scrip_data;
-            }
+#define LOAD_COLUMN(dest, schema_index, width)                                                           \
+        (dest) = malloc(num_records * (width));                                                          \
+        if (!(dest)) {                                                                                   \
+            fprintf(stderr, "❌ Failed to allocate memory for %s data for scrip %s\n",                   \
+                    COMPILED_SCHEMA_FIELDS[schema_index].name, scrip_name);                              \
+            fprintf(outfile, "❌ Failed to allocate memory for %s data for scrip %s\n",                  \
+                    COMPILED_SCHEMA_FIELDS[schema_index].name, scrip_name);                              \
+            goto cleanup_current_scrip_data;                                                             \
+        }                                                                                                \
+        if (file_column[schema_index] < 0) {                                                             \
+            memset((dest), 0, num_records * (width));                                                    \
+        } else {                                                                                         \
+            memcpy((dest), block + schema_column_offset(&schema, (uint32_t)file_column[schema_index], num_records), \
+                   num_records * (width));                                                               \
         }
+#define X(id, key, name) LOAD_COLUMN(temp_float_data[FLOAT_FIELD_##id], FLOAT_FIELD_##id, sizeof(float))
+        SCRIP_FLOAT_FIELDS(X)
+#undef X
+#define X(id, key, name) LOAD_COLUMN(temp_long_data[LONG_FIELD_##id], NUM_FLOAT_KEYS_CONST + LONG_FIELD_##id, sizeof(int64_t))
+        SCRIP_LONG_FIELDS(X)
+#undef X
+#undef LOAD_COLUMN
         scrip_read_success = true;
 
         fprintf(outfile, "  Data:\n    %-10s", "Index");
-        for(int i=0; i<NUM_FLOAT_KEYS_CONST; ++i)
-            fprintf(outfile, "%-15s", float_key_names[i]);
-        for(int i=0; i<NUM_LONG_KEYS_CONST; ++i)
-            fprintf(outfile, "%-15s", long_key_names[i]);
+#define X(id, key, name) fprintf(outfile, "%-15s", name);
+        SCRIP_FLOAT_FIELDS(X)
+        SCRIP_LONG_FIELDS(X)
+#undef X
+        for (uint32_t f = first_indicator; f < schema.field_count; ++f) {
+            fprintf(outfile, "%-15s", schema.fields[f].name);
+        }
         fprintf(outfile, "\n");
 
         for (size_t i = 0; i < num_records; ++i) {
             fprintf(outfile, "    %-10zu", i);
-            for (int k = 0; k < NUM_FLOAT_KEYS_CONST; ++k) {
-                fprintf(outfile, "%-15.2f", temp_float_data[k][i]);
-            }
-            for (int k = 0; k < NUM_LONG_KEYS_CONST; ++k) {
-                fprintf(outfile, "%-15ld", temp_long_data[k][i]);
+#define X(id, key, name) fprintf(outfile, "%-15.2f", temp_float_data[FLOAT_FIELD_##id][i]);
+            SCRIP_FLOAT_FIELDS(X)
+#undef X
+#define X(id, key, name) fprintf(outfile, "%-15" PRId64, temp_long_data[LONG_FIELD_##id][i]);
+            SCRIP_LONG_FIELDS(X)
+#undef X
+            // Indicator columns are float32 and printed straight from the block; warm-up bars print as nan.
+            for (uint32_t f = first_indicator; f < schema.field_count; ++f) {
+                float v;
+                memcpy(&v, block + schema_column_offset(&schema, f, num_records) + i * sizeof(float), sizeof(float));
+                fprintf(outfile, "%-15.2f", v);
             }
             fprintf(outfile, "\n");
         }
 
     cleanup_current_scrip_data:
+        free(block);
         for (int i = 0; i < NUM_FLOAT_KEYS_CONST; ++i) free(temp_float_data[i]);
         for (int i = 0; i < NUM_LONG_KEYS_CONST; ++i) free(temp_long_data[i]);
 
@@ -342,4 +601,300 @@ void read_and_print_binary_data_to_file(const char *input_filename, FILE *outfil
         fprintf(outfile, "❌ A general error occurred during file reading operations for %s\n", input_filename);
     }
     fclose(fin);
-}
\ No newline at end of file
+}
+
+// Copies a scrip of a mapped .bin into freshly allocated columns. Integer
+// columns of other widths (32-bit `long` writers) are widened to int64. With
+// copy_indicators the file's indicator columns and rolling state come along.
+static bool load_scrip_from_bin(const BinFile *bf, const BinScripEntry *entry, const int *file_column,
+                                bool copy_indicators, ScripInfo *out) {
+    size_t n = entry->num_records;
+    memset(out, 0, sizeof(*out));
+    memcpy(out->scrip_name, entry->name, (size_t)entry->name_len + 1);
+    out->scrip_name_len = entry->name_len;
+    out->expected_count = n;
+
+#define X(id, key, name)                                                                          \
+    if (file_column[FLOAT_FIELD_##id] >= 0) {                                                     \
+        FloatArray *arr = &out->float_data_arrays[FLOAT_FIELD_##id];                              \
+        if (!(arr->data = malloc(n * sizeof(float)))) goto fail;                                  \
+        memcpy(arr->data, bin_column(bf, entry, file_column[FLOAT_FIELD_##id]), n * sizeof(float)); \
+        arr->count = arr->capacity = n;                                                           \
+    }
+    SCRIP_FLOAT_FIELDS(X)
+#undef X
+#define X(id, key, name)                                                                          \
+    if (file_column[NUM_FLOAT_KEYS_CONST + LONG_FIELD_##id] >= 0) {                               \
+        int col = file_column[NUM_FLOAT_KEYS_CONST + LONG_FIELD_##id];                            \
+        LongArray *arr = &out->long_data_arrays[LONG_FIELD_##id];                                 \
+        if (!(arr->data = malloc(n * sizeof(int64_t)))) goto fail;                                \
+        const unsigned char *src = bin_column(bf, entry, col);                                    \
+        if (bf->schema.fields[col].width == sizeof(int64_t)) {                                    \
+            memcpy(arr->data, src, n * sizeof(int64_t));                                          \
+        } else {                                                                                  \
+            for (size_t i = 0; i < n; ++i) {                                                      \
+                int32_t v;                                                                        \
+                memcpy(&v, src + i * sizeof(int32_t), sizeof(int32_t));                           \
+                arr->data[i] = v;                                                                 \
+            }                                                                                     \
+        }                                                                                         \
+        arr->count = arr->capacity = n;                                                           \
+    }
+    SCRIP_LONG_FIELDS(X)
+#undef X
+
+    if (copy_indicators && bf->schema.indicator_state_bytes > 0) {
+        uint32_t first = bf->schema.first_indicator_field;
+        for (uint32_t c = 0; first + c < bf->schema.field_count; ++c) {
+            FloatArray *arr = &out->indicator_data_arrays[c];
+            if (!(arr->data = malloc(n * sizeof(float)))) goto fail;
+            memcpy(arr->data, bin_column(bf, entry, (int)(first + c)), n * sizeof(float));
+            arr->count = arr->capacity = n;
+        }
+        if (!(out->indicator_state = malloc(bf->schema.indicator_state_bytes))) goto fail;
+        memcpy(out->indicator_state, bin_indicator_state(bf, entry), bf->schema.indicator_state_bytes);
+        out->indicator_state_len = bf->schema.indicator_state_bytes / sizeof(double);
+    }
+    return true;
+
+fail:
+    fprintf(stderr, "❌ Failed to allocate columns while loading scrip %s\n", entry->name);
+    free_scrip_info_columns(out);
+    return false;
+}
+
+static bool same_file(const char *a, const char *b) {
+    struct stat sa, sb;
+    if (stat(a, &sa) != 0 || stat(b, &sb) != 0) return false;
+    return sa.st_dev == sb.st_dev && sa.st_ino == sb.st_ino;
+}
+
+// Maps every compiled field onto its column in the file (-1 when absent).
+// Fails on a column whose type cannot be widened to the compiled one.
+static bool map_compiled_columns(const BinFile *bf, const char *input_filename, int *file_column) {
+    for (int i = 0; i < TOTAL_KEYS_CONST; ++i) {
+        const FieldDesc *want = &COMPILED_SCHEMA_FIELDS[i];
+        file_column[i] = find_schema_field(&bf->schema, want->key);
+        if (file_column[i] < 0) {
+            printf("ℹ️ Field %s not present in %s, writing zeros.\n", want->name, input_filename);
+            continue;
+        }
+        const FieldDesc *have = &bf->schema.fields[file_column[i]];
+        bool compatible = have->type == want->type &&
+            (have->width == want->width || (have->type == FIELD_TYPE_LONG && have->width == sizeof(int32_t)));
+        if (!compatible) {
+            fprintf(stderr, "❌ Field %s in %s has type %u / width %u, cannot convert to %u / %u\n",
+                    want->name, input_filename, have->type, have->width, want->type, want->width);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Loads every valid scrip of bf with its indicators brought up to layout:
+// copied when the file already has them, computed from scratch otherwise.
+// scrip_slot, when given, receives each directory entry's index in scrips
+// (SIZE_MAX for skipped entries).
+static bool load_bin_scrips(const BinFile *bf, const int *file_column, const FileSchema *layout,
+                            ScripInfoArray *scrips, SpillStore *spill, size_t *scrip_slot) {
+    bool copy_indicators = same_indicators(&bf->schema, layout);
+    for (size_t s = 0; s < bf->scrip_count; ++s) {
+        const BinScripEntry *entry = &bf->scrips[s];
+        if (scrip_slot) scrip_slot[s] = SIZE_MAX;
+        if (entry->num_records == 0) {
+            fprintf(stderr, "⚠️ Skipping %s: invalid data offsets\n", entry->name);
+            continue;
+        }
+        ScripInfo scrip;
+        if (!load_scrip_from_bin(bf, entry, file_column, copy_indicators, &scrip)) return false;
+        if (!update_scrip_indicators(layout, &scrip)) {
+            fprintf(stderr, "❌ Failed to compute indicators for %s\n", entry->name);
+            free_scrip_info_columns(&scrip);
+            return false;
+        }
+        size_t before = scrips->count;
+        add_to_scrip_info_array(scrips, scrip);
+        if (scrips->count == before) return false;
+        if (scrip_slot) scrip_slot[s] = before;
+        if (spill && !spill_if_over_budget(spill, layout, scrips)) return false;
+    }
+    return true;
+}
+
+bool convert_binary_file(const char *input_filename, const char *output_filename,
+                         const IndicatorSpec *indicators, uint32_t indicator_count, SpillStore *spill) {
+    if (same_file(input_filename, output_filename)) {
+        fprintf(stderr, "❌ Refusing to convert %s onto itself\n", input_filename);
+        return false;
+    }
+    BinFile bf;
+    if (!bin_open(input_filename, &bf)) return false;
+
+    int file_column[TOTAL_KEYS_CONST];
+    FileSchema layout;
+    if (!indicators) {
+        indicators = bf.schema.indicators;
+        indicator_count = bf.schema.indicator_count;
+    }
+    if (!map_compiled_columns(&bf, input_filename, file_column) ||
+        !compiled_file_schema(&layout, indicators, indicator_count)) {
+        bin_close(&bf);
+        return false;
+    }
+
+    ScripInfoArray scrips;
+    init_scrip_info_array(&scrips);
+    bool ok = scrips.capacity > 0 && load_bin_scrips(&bf, file_column, &layout, &scrips, spill, NULL);
+
+    if (ok) {
+        printf("Converting %s (format v%u, %zu scrips) to format v%u with %u indicators\n",
+               input_filename, bf.schema.version, scrips.count, BIN_FORMAT_VERSION, layout.indicator_count);
+        ok = write_binary_two_pass(output_filename, &layout, &scrips, spill);
+    }
+    free_scrip_info_array(&scrips);
+    bin_close(&bf);
+    return ok;
+}
+
+typedef struct {
+    const FileSchema *layout;
+    const BinFile *bf;
+    ScripInfoArray *scrips;
+    const size_t *scrip_slot; // Index in scrips per directory entry of bf
+    size_t loaded_count;      // Scrips before this index came from bf
+    size_t bars_appended;
+    size_t scrips_extended;
+    size_t scrips_added;
+    bool ok;
+} ExtendContext;
+
+static ScripInfo *find_extend_target(ExtendContext *ext, const char *name) {
+    long idx = bin_find_scrip(ext->bf, name);
+    if (idx >= 0 && ext->scrip_slot[idx] != SIZE_MAX) return &ext->scrips->scrips[ext->scrip_slot[idx]];
+    for (size_t i = ext->loaded_count; i < ext->scrips->count; ++i) {
+        if (strcmp(ext->scrips->scrips[i].scrip_name, name) == 0) return &ext->scrips->scrips[i];
+    }
+    return NULL;
+}
+
+// Appends bars [from, src->expected_count) of src to dst. A column missing on
+// either side is zero-filled, as the writer does for absent columns.
+static bool append_bars(ScripInfo *dst, const ScripInfo *src, size_t from) {
+    size_t have = dst->expected_count;
+#define APPEND_COLUMN(dst_arr, src_arr, add_fn)                                                    \
+    for (size_t i = (dst_arr)->count; i < have; ++i) {                                             \
+        if (!add_fn((dst_arr), 0)) return false;                                                   \
+    }                                                                                              \
+    for (size_t i = from; i < src->expected_count; ++i) {                                          \
+        if (!add_fn((dst_arr), (src_arr)->count > 0 ? (src_arr)->data[i] : 0)) return false;       \
+    }
+#define X(id, key, name) APPEND_COLUMN(&dst->float_data_arrays[FLOAT_FIELD_##id], &src->float_data_arrays[FLOAT_FIELD_##id], add_to_float_array)
+    SCRIP_FLOAT_FIELDS(X)
+#undef X
+#define X(id, key, name) APPEND_COLUMN(&dst->long_data_arrays[LONG_FIELD_##id], &src->long_data_arrays[LONG_FIELD_##id], add_to_long_array)
+    SCRIP_LONG_FIELDS(X)
+#undef X
+#undef APPEND_COLUMN
+    dst->expected_count = have + (src->expected_count - from);
+    return true;
+}
+
+static void extend_json_entry(const char *filename_in_zip, char *content, void *ctx) {
+    ExtendContext *ext = ctx;
+    ScripInfo update;
+    bool parsed = parse_json_to_scrip_info(content, filename_in_zip, &update);
+    free(content);
+    if (!parsed) return;
+
+    // New bars are placed by timestamp, so an update without strictly increasing ones cannot be merged.
+    const LongArray *new_t = &update.long_data_arrays[LONG_FIELD_TIMESTAMP];
+    if (new_t->count != update.expected_count) {
+        fprintf(stderr, "❌ %s has no timestamps, cannot extend %s with it\n", filename_in_zip, update.scrip_name);
+        free_scrip_info_columns(&update);
+        ext->ok = false;
+        return;
+    }
+    if (!scrip_timestamps_increasing(&update, filename_in_zip)) {
+        free_scrip_info_columns(&update);
+        ext->ok = false;
+        return;
+    }
+
+    ScripInfo *target = find_extend_target(ext, update.scrip_name);
+    if (!target) {
+        // A scrip the file does not have yet is taken whole.
+        size_t before = ext->scrips->count;
+        if (update_scrip_indicators(ext->layout, &update)) {
+            add_to_scrip_info_array(ext->scrips, update);
+        } else {
+            free_scrip_info_columns(&update);
+        }
+        if (ext->scrips->count == before) {
+            fprintf(stderr, "❌ Failed to add new scrip from %s\n", filename_in_zip);
+            ext->ok = false;
+            return;
+        }
+        ext->scrips_added++;
+        ext->bars_appended += update.expected_count;
+        return;
+    }
+
+    // Only bars after the last stored timestamp are new; consecutive exports may overlap.
+    const LongArray *stored_t = &target->long_data_arrays[LONG_FIELD_TIMESTAMP];
+    if (stored_t->count != target->expected_count) {
+        fprintf(stderr, "❌ %s has no stored timestamps, cannot tell which bars are new\n", target->scrip_name);
+        free_scrip_info_columns(&update);
+        ext->ok = false;
+        return;
+    }
+    int64_t last = stored_t->data[stored_t->count - 1];
+    size_t from = 0;
+    while (from < update.expected_count && new_t->data[from] <= last) from++;
+    if (from < update.expected_count) {
+        // The indicators resume from the stored state: only the new bars are computed.
+        if (append_bars(target, &update, from) && update_scrip_indicators(ext->layout, target)) {
+            ext->scrips_extended++;
+            ext->bars_appended += update.expected_count - from;
+        } else {
+            fprintf(stderr, "❌ Failed to extend %s\n", target->scrip_name);
+            ext->ok = false;
+        }
+    }
+    free_scrip_info_columns(&update);
+}
+
+bool extend_binary_file(const char *input_filename, const char *zip_path, const char *output_filename) {
+    if (same_file(input_filename, output_filename)) {
+        fprintf(stderr, "❌ Refusing to extend %s in place; write a new file and rename it over\n", input_filename);
+        return false;
+    }
+    BinFile bf;
+    if (!bin_open(input_filename, &bf)) return false;
+
+    int file_column[TOTAL_KEYS_CONST];
+    FileSchema layout;
+    if (!map_compiled_columns(&bf, input_filename, file_column) ||
+        !compiled_file_schema(&layout, bf.schema.indicators, bf.schema.indicator_count)) {
+        bin_close(&bf);
+        return false;
+    }
+
+    ScripInfoArray scrips;
+    init_scrip_info_array(&scrips);
+    size_t *scrip_slot = malloc((bf.scrip_count + 1) * sizeof(size_t));
+    bool ok = scrips.capacity > 0 && scrip_slot &&
+              load_bin_scrips(&bf, file_column, &layout, &scrips, NULL, scrip_slot);
+
+    ExtendContext ext = { &layout, &bf, &scrips, scrip_slot, scrips.count, 0, 0, 0, true };
+    if (ok) ok = for_each_json_in_zip(zip_path, extend_json_entry, &ext) && ext.ok;
+
+    if (ok) {
+        printf("Extending %s: %zu new bars across %zu scrips, %zu new scrips, %u indicators resumed\n",
+               input_filename, ext.bars_appended, ext.scrips_extended, ext.scrips_added, layout.indicator_count);
+        ok = write_binary_two_pass(output_filename, &layout, &scrips, NULL);
+    }
+    free(scrip_slot);
+    free_scrip_info_array(&scrips);
+    bin_close(&bf);
+    return ok;
+}
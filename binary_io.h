@@ -2,9 +2,28 @@
 #define BINARY_IO_H
 
 #include "data_structures.h" // For ScripInfoArray
+#include "spill.h"           // For SpillStore
 #include <stdio.h>           // For FILE*
 
-bool write_binary_two_pass(const char *output_filename, ScripInfoArray *all_scrips_info);
+// Writes the scrip's block in on-disk order at the current position of fout,
+// returning the CRC32C of the bytes written in out_crc.
+bool write_scrip_block(FILE *fout, const FileSchema *layout, const ScripInfo *scrip, uint32_t *out_crc);
+// layout comes from compiled_file_schema. spill may be NULL when nothing was
+// spilled during ingest.
+bool write_binary_two_pass(const char *output_filename, const FileSchema *layout, ScripInfoArray *all_scrips_info, SpillStore *spill);
 void read_and_print_binary_data_to_file(const char *input_filename, FILE *outfile);
+// Rewrites any readable .bin (legacy v2 included) in the current format,
+// matching columns by key. With indicators NULL the input's indicators are
+// kept (and copied as is); otherwise the given set is computed from scratch.
+// spill bounds memory as during ingest.
+bool convert_binary_file(const char *input_filename, const char *output_filename,
+                         const IndicatorSpec *indicators, uint32_t indicator_count, SpillStore *spill);
+// Appends the bars of zip_path newer than each scrip's last timestamp to the
+// scrips of input_filename and writes the result to output_filename. Indicator
+// columns resume from the rolling state stored in the input, so only the new
+// bars are computed. Scrips not in the input are added whole. Fails when an
+// update's timestamps are missing or not strictly increasing, or a stored
+// scrip has no timestamps to order the new bars against.
+bool extend_binary_file(const char *input_filename, const char *zip_path, const char *output_filename);
 
 #endif // BINARY_IO_H
\ No newline at end of file
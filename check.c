@@ -0,0 +1,93 @@
+#include "check.h"
+#include "bin_reader.h"
+#include "crc32c.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>   // For clock_gettime
+#include <unistd.h> // For sysconf
+
+typedef struct {
+    const BinFile *bf;
+    atomic_size_t next_scrip;
+    atomic_size_t problems;
+    atomic_uint_fast64_t bytes_checked;
+} CheckContext;
+
+static void *check_worker(void *arg) {
+    CheckContext *cc = arg;
+    const BinFile *bf = cc->bf;
+    for (;;) {
+        size_t i = atomic_fetch_add(&cc->next_scrip, 1);
+        if (i >= bf->scrip_count) break;
+        const BinScripEntry *e = &bf->scrips[i];
+        if (e->num_records == 0) continue; // Already reported by bin_check_offsets
+        if (!bin_verify_block(bf, i)) {
+            atomic_fetch_add(&cc->problems, 1);
+            fprintf(stderr, "❌ %s: block checksum mismatch\n", e->name);
+        }
+        atomic_fetch_add(&cc->bytes_checked, e->block_end - e->data_start);
+    }
+    return NULL;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+int run_check(const char *bin_path, int num_threads) {
+    if (num_threads <= 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = cores > 0 ? (int)cores : 1;
+    }
+
+    // bin_open already rejects a file whose header checksum does not match.
+    BinFile bf;
+    if (!bin_open(bin_path, &bf)) return 1;
+    if (!bin_has_checksums(&bf)) {
+        fprintf(stderr, "❌ %s is format v%u and has no checksums; rewrite it with `convert` first\n",
+                bin_path, bf.schema.version);
+        bin_close(&bf);
+        return 1;
+    }
+
+    CheckContext cc;
+    cc.bf = &bf;
+    atomic_init(&cc.next_scrip, 0);
+    atomic_init(&cc.problems, bin_check_offsets(&bf, stderr));
+    atomic_init(&cc.bytes_checked, 0);
+
+    double start = now_seconds();
+    pthread_t *threads = malloc((size_t)num_threads * sizeof(pthread_t));
+    if (!threads) {
+        perror("❌ Failed to allocate check threads");
+        bin_close(&bf);
+        return 1;
+    }
+    int started = 0;
+    for (; started < num_threads; ++started) {
+        if (pthread_create(&threads[started], NULL, check_worker, &cc) != 0) {
+            perror("❌ Failed to start check thread");
+            break;
+        }
+    }
+    if (started == 0) check_worker(&cc);
+    for (int i = 0; i < started; ++i) pthread_join(threads[i], NULL);
+    free(threads);
+    double elapsed = now_seconds() - start;
+
+    size_t problems = atomic_load(&cc.problems);
+    double mb = (double)atomic_load(&cc.bytes_checked) / (1024.0 * 1024.0);
+    if (problems == 0) {
+        printf("✅ %s is intact: %zu scrips, %.2f MB checked in %.3f s (%.0f MB/s, CRC32C %s, %d threads)\n",
+               bin_path, bf.scrip_count, mb, elapsed, elapsed > 0 ? mb / elapsed : 0.0,
+               crc32c_implementation(), started > 0 ? started : 1);
+    } else {
+        fprintf(stderr, "❌ %zu problems found in %s\n", problems, bin_path);
+    }
+    bin_close(&bf);
+    return problems == 0 ? 0 : 1;
+}
@@ -0,0 +1,11 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+// --- Integrity check ---
+// Verifies the header checksum, the directory offsets and the CRC32C of every
+// scrip block of a v6+ .bin, with num_threads workers (<= 0 picks the number
+// of cores) pulling blocks from the mapping. Needs no source zip.
+// Returns 0 when the file is intact, 1 otherwise.
+int run_check(const char *bin_path, int num_threads);
+
+#endif // CHECK_H
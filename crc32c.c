@@ -0,0 +1,186 @@
+#include "crc32c.h"
+#include <string.h>
+#include <pthread.h>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h> // For _mm_crc32_u64
+#define CRC32C_HAVE_SSE42 1
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>  // For __crc32cd
+#define CRC32C_HAVE_ARM_CRC 1
+#endif
+
+#define CRC32C_POLY 0x82F63B78u // Reflected Castagnoli polynomial
+// Hardware paths run three independent lanes of this many bytes so the
+// crc32 instruction's latency is hidden, then stitch the lanes together.
+#define CRC32C_LANE_BYTES 4096
+
+static uint32_t crc_table[8][256];
+static uint32_t lane_shift; // x^(8 * CRC32C_LANE_BYTES) mod P
+static uint32_t (*crc_impl)(uint32_t crc, const unsigned char *p, size_t len);
+static const char *crc_impl_name;
+static pthread_once_t crc_once = PTHREAD_ONCE_INIT;
+
+static uint32_t crc32c_software(uint32_t crc, const unsigned char *p, size_t len) {
+    while (len > 0 && ((uintptr_t)p & 7) != 0) {
+        crc = crc_table[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+        len--;
+    }
+    while (len >= 8) {
+        // Little-endian word order, as the table layout assumes.
+        uint32_t lo = (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+        uint32_t hi = (uint32_t)p[4] | (uint32_t)p[5] << 8 | (uint32_t)p[6] << 16 | (uint32_t)p[7] << 24;
+        lo ^= crc;
+        crc = crc_table[7][lo & 0xff] ^ crc_table[6][(lo >> 8) & 0xff] ^
+              crc_table[5][(lo >> 16) & 0xff] ^ crc_table[4][lo >> 24] ^
+              crc_table[3][hi & 0xff] ^ crc_table[2][(hi >> 8) & 0xff] ^
+              crc_table[1][(hi >> 16) & 0xff] ^ crc_table[0][hi >> 24];
+        p += 8;
+        len -= 8;
+    }
+    while (len-- > 0) crc = crc_table[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+    return crc;
+}
+
+#if defined(CRC32C_HAVE_SSE42) || defined(CRC32C_HAVE_ARM_CRC)
+#define CRC32C_HAVE_LANES 1
+#endif
+
+#if defined(CRC32C_HAVE_LANES)
+// a * b modulo the CRC polynomial, in the reflected bit order (as in zlib).
+static uint32_t multmodp(uint32_t a, uint32_t b) {
+    uint32_t m = (uint32_t)1 << 31, p = 0;
+    for (;;) {
+        if (a & m) {
+            p ^= b;
+            if ((a & (m - 1)) == 0) break;
+        }
+        m >>= 1;
+        b = (b & 1) ? (b >> 1) ^ CRC32C_POLY : b >> 1;
+    }
+    return p;
+}
+
+// x^(8 * bytes) mod P: multiplying a finished CRC by this appends `bytes` zeros.
+static uint32_t zeros_operator(size_t bytes) {
+    uint32_t power = (uint32_t)1 << 30; // x^1
+    uint32_t result = (uint32_t)1 << 31; // x^0
+    for (size_t n = bytes * 8; n > 0; n >>= 1) {
+        if (n & 1) result = multmodp(power, result);
+        power = multmodp(power, power);
+    }
+    return result;
+}
+
+// Joins three lane states (pre-inverted, as the instructions keep them),
+// the first seeded with the running CRC and the others with ~0.
+static uint32_t combine_lanes(uint32_t a, uint32_t b, uint32_t c) {
+    uint32_t crc = multmodp(lane_shift, ~a) ^ ~b;
+    return ~(multmodp(lane_shift, crc) ^ ~c);
+}
+#endif
+
+#if defined(CRC32C_HAVE_SSE42)
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_sse42(uint32_t crc, const unsigned char *p, size_t len) {
+    uint64_t c = crc;
+    while (len > 0 && ((uintptr_t)p & 7) != 0) {
+        c = _mm_crc32_u8((uint32_t)c, *p++);
+        len--;
+    }
+    while (len >= 3 * CRC32C_LANE_BYTES) {
+        uint64_t c1 = 0xFFFFFFFFu, c2 = 0xFFFFFFFFu;
+        for (size_t i = 0; i < CRC32C_LANE_BYTES; i += 8) {
+            uint64_t w0, w1, w2;
+            memcpy(&w0, p + i, 8);
+            memcpy(&w1, p + CRC32C_LANE_BYTES + i, 8);
+            memcpy(&w2, p + 2 * CRC32C_LANE_BYTES + i, 8);
+            c = _mm_crc32_u64(c, w0);
+            c1 = _mm_crc32_u64(c1, w1);
+            c2 = _mm_crc32_u64(c2, w2);
+        }
+        c = combine_lanes((uint32_t)c, (uint32_t)c1, (uint32_t)c2);
+        p += 3 * CRC32C_LANE_BYTES;
+        len -= 3 * CRC32C_LANE_BYTES;
+    }
+    while (len >= 8) {
+        uint64_t word;
+        memcpy(&word, p, sizeof(word));
+        c = _mm_crc32_u64(c, word);
+        p += 8;
+        len -= 8;
+    }
+    while (len-- > 0) c = _mm_crc32_u8((uint32_t)c, *p++);
+    return (uint32_t)c;
+}
+#elif defined(CRC32C_HAVE_ARM_CRC)
+static uint32_t crc32c_arm(uint32_t crc, const unsigned char *p, size_t len) {
+    while (len > 0 && ((uintptr_t)p & 7) != 0) {
+        crc = __crc32cb(crc, *p++);
+        len--;
+    }
+    while (len >= 3 * CRC32C_LANE_BYTES) {
+        uint32_t c1 = 0xFFFFFFFFu, c2 = 0xFFFFFFFFu;
+        for (size_t i = 0; i < CRC32C_LANE_BYTES; i += 8) {
+            uint64_t w0, w1, w2;
+            memcpy(&w0, p + i, 8);
+            memcpy(&w1, p + CRC32C_LANE_BYTES + i, 8);
+            memcpy(&w2, p + 2 * CRC32C_LANE_BYTES + i, 8);
+            crc = __crc32cd(crc, w0);
+            c1 = __crc32cd(c1, w1);
+            c2 = __crc32cd(c2, w2);
+        }
+        crc = combine_lanes(crc, c1, c2);
+        p += 3 * CRC32C_LANE_BYTES;
+        len -= 3 * CRC32C_LANE_BYTES;
+    }
+    while (len >= 8) {
+        uint64_t word;
+        memcpy(&word, p, sizeof(word));
+        crc = __crc32cd(crc, word);
+        p += 8;
+        len -= 8;
+    }
+    while (len-- > 0) crc = __crc32cb(crc, *p++);
+    return crc;
+}
+#endif
+
+static void crc32c_init(void) {
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; ++k) c = (c & 1) ? (c >> 1) ^ CRC32C_POLY : c >> 1;
+        crc_table[0][i] = c;
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+        for (int t = 1; t < 8; ++t) {
+            crc_table[t][i] = crc_table[0][crc_table[t - 1][i] & 0xff] ^ (crc_table[t - 1][i] >> 8);
+        }
+    }
+
+#if defined(CRC32C_HAVE_LANES)
+    lane_shift = zeros_operator(CRC32C_LANE_BYTES);
+#endif
+
+    crc_impl = crc32c_software;
+    crc_impl_name = "software (slicing-by-8)";
+#if defined(CRC32C_HAVE_SSE42)
+    if (__builtin_cpu_supports("sse4.2")) {
+        crc_impl = crc32c_sse42;
+        crc_impl_name = "SSE4.2";
+    }
+#elif defined(CRC32C_HAVE_ARM_CRC)
+    crc_impl = crc32c_arm;
+    crc_impl_name = "ARMv8 CRC";
+#endif
+}
+
+uint32_t crc32c(uint32_t crc, const void *data, size_t len) {
+    pthread_once(&crc_once, crc32c_init);
+    return ~crc_impl(~crc, data, len);
+}
+
+const char *crc32c_implementation(void) {
+    pthread_once(&crc_once, crc32c_init);
+    return crc_impl_name;
+}
@@ -0,0 +1,16 @@
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// --- CRC32C (Castagnoli) ---
+// Same calling convention as zlib's crc32: start from 0 and feed the result
+// of the previous call to extend a running checksum over several buffers.
+// Uses the SSE4.2 crc32 instruction (or ARMv8 CRC) when the CPU has it and
+// a slicing-by-8 table otherwise; all paths give identical results.
+uint32_t crc32c(uint32_t crc, const void *data, size_t len);
+// Name of the implementation in use, for diagnostics.
+const char *crc32c_implementation(void);
+
+#endif // CRC32C_H
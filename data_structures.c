@@ -43,7 +43,7 @@ void free_float_array(FloatArray *arr) {
 
 // --- LongArray Helper Functions ---
 void init_long_array(LongArray *arr) {
-    arr->data = malloc(INITIAL_CAPACITY * sizeof(long int));
+    arr->data = malloc(INITIAL_CAPACITY * sizeof(int64_t));
     if (!arr->data) {
         perror("❌ Failed to allocate memory for LongArray");
         arr->count = 0;
@@ -54,14 +54,14 @@ void init_long_array(LongArray *arr) {
     arr->capacity = INITIAL_CAPACITY;
 }
 
-bool add_to_long_array(LongArray *arr, long int value) {
+bool add_to_long_array(LongArray *arr, int64_t value) {
     if (arr->capacity == 0 && arr->data == NULL) {
         init_long_array(arr);
         if(arr->capacity == 0) return false;
     }
     if (arr->count >= arr->capacity) {
         size_t new_capacity = arr->capacity == 0 ? INITIAL_CAPACITY : arr->capacity * 2;
-        long int *temp = realloc(arr->data, new_capacity * sizeof(long int));
+        int64_t *temp = realloc(arr->data, new_capacity * sizeof(int64_t));
         if (!temp) {
             perror("❌ Failed to reallocate memory for LongArray");
             return false;
@@ -80,6 +80,24 @@ void free_long_array(LongArray *arr) {
     arr->capacity = 0;
 }
 
+// --- ScripInfo Helper Functions ---
+size_t scrip_info_resident_bytes(const ScripInfo *scrip) {
+    size_t bytes = 0;
+    for (int j = 0; j < NUM_FLOAT_KEYS_CONST; ++j) bytes += scrip->float_data_arrays[j].capacity * sizeof(float);
+    for (int j = 0; j < NUM_LONG_KEYS_CONST; ++j) bytes += scrip->long_data_arrays[j].capacity * sizeof(int64_t);
+    for (int j = 0; j < MAX_INDICATOR_COLUMNS; ++j) bytes += scrip->indicator_data_arrays[j].capacity * sizeof(float);
+    return bytes + scrip->indicator_state_len * sizeof(double);
+}
+
+void free_scrip_info_columns(ScripInfo *scrip) {
+    for (int j = 0; j < NUM_FLOAT_KEYS_CONST; ++j) free_float_array(&scrip->float_data_arrays[j]);
+    for (int j = 0; j < NUM_LONG_KEYS_CONST; ++j) free_long_array(&scrip->long_data_arrays[j]);
+    for (int j = 0; j < MAX_INDICATOR_COLUMNS; ++j) free_float_array(&scrip->indicator_data_arrays[j]);
+    free(scrip->indicator_state);
+    scrip->indicator_state = NULL;
+    scrip->indicator_state_len = 0;
+}
+
 // --- ScripInfoArray Helper Functions ---
 void init_scrip_info_array(ScripInfoArray *arr) {
     arr->scrips = malloc(INITIAL_CAPACITY * sizeof(ScripInfo));
@@ -101,8 +119,7 @@ void add_to_scrip_info_array(ScripInfoArray *arr, ScripInfo scrip_to_add) {
         if (!temp) {
             perror("❌ Failed to reallocate memory for ScripInfoArray");
             // Free internal arrays of scrip_to_add to prevent leaks if realloc fails
-            for (int j = 0; j < NUM_FLOAT_KEYS_CONST; ++j) free_float_array(&scrip_to_add.float_data_arrays[j]);
-            for (int j = 0; j < NUM_LONG_KEYS_CONST; ++j) free_long_array(&scrip_to_add.long_data_arrays[j]);
+            free_scrip_info_columns(&scrip_to_add);
             return;
         }
         arr->scrips = temp;
@@ -113,12 +130,7 @@ void add_to_scrip_info_array(ScripInfoArray *arr, ScripInfo scrip_to_add) {
 void free_scrip_info_array(ScripInfoArray *arr) {
     if (arr->scrips) {
         for (size_t i = 0; i < arr->count; ++i) {
-            for (int j = 0; j < NUM_FLOAT_KEYS_CONST; ++j) {
-                free_float_array(&arr->scrips[i].float_data_arrays[j]);
-            }
-            for (int j = 0; j < NUM_LONG_KEYS_CONST; ++j) {
-                free_long_array(&arr->scrips[i].long_data_arrays[j]);
-            }
+            free_scrip_info_columns(&arr->scrips[i]);
         }
         free(arr->scrips);
     }
@@ -4,10 +4,9 @@
 #include <stddef.h> // For size_t
 #include <stdbool.h>
 #include <stdint.h> // For uint64_t
+#include "schema.h" // For NUM_FLOAT_KEYS_CONST, NUM_LONG_KEYS_CONST, MAX_INDICATOR_COLUMNS
 
 #define INITIAL_CAPACITY 100
-#define NUM_FLOAT_KEYS_CONST 4
-#define NUM_LONG_KEYS_CONST 2
 
 // --- Dynamic array for floats ---
 typedef struct {
@@ -20,15 +19,15 @@ void init_float_array(FloatArray *arr);
 bool add_to_float_array(FloatArray *arr, float value);
 void free_float_array(FloatArray *arr);
 
-// --- Dynamic array for long ints ---
+// --- Dynamic array for integer columns (fixed 64-bit on every platform) ---
 typedef struct {
-    long int *data;
+    int64_t *data;
     size_t count;
     size_t capacity;
 } LongArray;
 
 void init_long_array(LongArray *arr);
-bool add_to_long_array(LongArray *arr, long int value);
+bool add_to_long_array(LongArray *arr, int64_t value);
 void free_long_array(LongArray *arr);
 
 // --- ScripInfo and ScripInfoArray ---
@@ -40,8 +39,21 @@ typedef struct {
     FloatArray float_data_arrays[NUM_FLOAT_KEYS_CONST];
     LongArray long_data_arrays[NUM_LONG_KEYS_CONST];
 
+    // Indicator columns in file layout order (see indicators.h) and the
+    // rolling state they were computed up to; empty when none are configured.
+    FloatArray indicator_data_arrays[MAX_INDICATOR_COLUMNS];
+    double *indicator_state;
+    size_t indicator_state_len; // Doubles
+
     uint64_t file_offset_for_data_start_ptr;
     uint64_t file_offset_for_data_end_ptr;
+
+    // Set once the columns were moved to the spill file (see spill.h);
+    // the arrays above are freed at that point.
+    bool is_spilled;
+    uint64_t spill_offset;
+    uint64_t spill_length;
+    uint32_t spill_crc; // CRC32C of the spilled block, computed as it was written
 } ScripInfo;
 
 typedef struct {
@@ -50,6 +62,10 @@ typedef struct {
     size_t capacity;
 } ScripInfoArray;
 
+// Heap bytes held by the scrip's decoded columns.
+size_t scrip_info_resident_bytes(const ScripInfo *scrip);
+void free_scrip_info_columns(ScripInfo *scrip);
+
 void init_scrip_info_array(ScripInfoArray *arr);
 void add_to_scrip_info_array(ScripInfoArray *arr, ScripInfo scrip_to_add);
 void free_scrip_info_array(ScripInfoArray *arr);
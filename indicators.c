@@ -0,0 +1,278 @@
+#include "indicators.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>   // For NAN, sqrt
+#include <ctype.h>  // For isdigit
+
+// Each kernel advances its state over close[begin, end) and writes out[c][i]
+// for its columns. States are arrays of doubles (see indicator_state_doubles);
+// bar counts are exact in a double far beyond any real history.
+
+// SMA: count | sum | window[period]
+static void sma_kernel(const IndicatorSpec *spec, double *st, const float *close,
+                       size_t begin, size_t end, float *const *out) {
+    uint32_t n = spec->period;
+    double count = st[0], sum = st[1];
+    double *window = st + 2;
+    for (size_t i = begin; i < end; ++i) {
+        double x = close[i];
+        size_t slot = (size_t)((uint64_t)count % n);
+        if (count >= n) sum -= window[slot];
+        window[slot] = x;
+        sum += x;
+        count += 1;
+        out[0][i] = count >= n ? (float)(sum / n) : NAN;
+    }
+    st[0] = count;
+    st[1] = sum;
+}
+
+// EMA seeded with the SMA of the first period bars: count | seed sum | ema
+static void ema_kernel(const IndicatorSpec *spec, double *st, const float *close,
+                       size_t begin, size_t end, float *const *out) {
+    uint32_t n = spec->period;
+    double alpha = 2.0 / (n + 1.0);
+    double count = st[0], seed = st[1], ema = st[2];
+    for (size_t i = begin; i < end; ++i) {
+        double x = close[i];
+        count += 1;
+        if (count < n) {
+            seed += x;
+            out[0][i] = NAN;
+            continue;
+        }
+        if (count == n) {
+            seed += x;
+            ema = seed / n;
+        } else {
+            ema += alpha * (x - ema);
+        }
+        out[0][i] = (float)ema;
+    }
+    st[0] = count;
+    st[1] = seed;
+    st[2] = ema;
+}
+
+static double rsi_value(double avg_gain, double avg_loss) {
+    if (avg_loss == 0) return avg_gain == 0 ? 50.0 : 100.0;
+    return 100.0 - 100.0 / (1.0 + avg_gain / avg_loss);
+}
+
+// RSI with Wilder smoothing: count | previous close | average gain | average loss.
+// The averages hold plain sums until the first period changes are seen.
+static void rsi_kernel(const IndicatorSpec *spec, double *st, const float *close,
+                       size_t begin, size_t end, float *const *out) {
+    uint32_t n = spec->period;
+    double count = st[0], prev = st[1], avg_gain = st[2], avg_loss = st[3];
+    for (size_t i = begin; i < end; ++i) {
+        double x = close[i];
+        if (count == 0) {
+            prev = x;
+            count = 1;
+            out[0][i] = NAN;
+            continue;
+        }
+        double change = x - prev;
+        double gain = change > 0 ? change : 0;
+        double loss = change < 0 ? -change : 0;
+        prev = x;
+        if (count <= n) {
+            avg_gain += gain;
+            avg_loss += loss;
+            if (count == n) {
+                avg_gain /= n;
+                avg_loss /= n;
+            }
+        } else {
+            avg_gain = (avg_gain * (n - 1) + gain) / n;
+            avg_loss = (avg_loss * (n - 1) + loss) / n;
+        }
+        count += 1;
+        out[0][i] = count > n ? (float)rsi_value(avg_gain, avg_loss) : NAN;
+    }
+    st[0] = count;
+    st[1] = prev;
+    st[2] = avg_gain;
+    st[3] = avg_loss;
+}
+
+// Bollinger bands: count | sum | sum of squares | window[period]
+static void bollinger_kernel(const IndicatorSpec *spec, double *st, const float *close,
+                             size_t begin, size_t end, float *const *out) {
+    uint32_t n = spec->period;
+    double k = spec->num_stddev;
+    double count = st[0], sum = st[1], sum_sq = st[2];
+    double *window = st + 3;
+    for (size_t i = begin; i < end; ++i) {
+        double x = close[i];
+        size_t slot = (size_t)((uint64_t)count % n);
+        if (count >= n) {
+            sum -= window[slot];
+            sum_sq -= window[slot] * window[slot];
+        }
+        window[slot] = x;
+        sum += x;
+        sum_sq += x * x;
+        count += 1;
+        if (count < n) {
+            out[0][i] = out[1][i] = out[2][i] = NAN;
+            continue;
+        }
+        double mean = sum / n;
+        double variance = sum_sq / n - mean * mean;
+        double band = k * sqrt(variance > 0 ? variance : 0);
+        out[0][i] = (float)mean;
+        out[1][i] = (float)(mean + band);
+        out[2][i] = (float)(mean - band);
+    }
+    st[0] = count;
+    st[1] = sum;
+    st[2] = sum_sq;
+}
+
+typedef void (*IndicatorKernel)(const IndicatorSpec *spec, double *st, const float *close,
+                                size_t begin, size_t end, float *const *out);
+
+static IndicatorKernel kernel_for(const IndicatorSpec *spec) {
+    switch (spec->kind) {
+    case INDICATOR_SMA: return sma_kernel;
+    case INDICATOR_EMA: return ema_kernel;
+    case INDICATOR_RSI: return rsi_kernel;
+    case INDICATOR_BOLLINGER: return bollinger_kernel;
+    default: return NULL;
+    }
+}
+
+static bool reserve_float_array(FloatArray *arr, size_t capacity) {
+    if (arr->capacity >= capacity) return true;
+    float *temp = realloc(arr->data, capacity * sizeof(float));
+    if (!temp) {
+        perror("❌ Failed to grow indicator column");
+        return false;
+    }
+    arr->data = temp;
+    arr->capacity = capacity;
+    return true;
+}
+
+bool update_scrip_indicators(const FileSchema *layout, ScripInfo *scrip) {
+    if (layout->indicator_count == 0) return true;
+    size_t num_columns = layout->field_count - layout->first_indicator_field;
+    size_t state_len = layout->indicator_state_bytes / sizeof(double);
+    size_t n = scrip->expected_count;
+    size_t done = scrip->indicator_data_arrays[0].count;
+
+    // Without a state for this layout there is nothing to resume from.
+    if (!scrip->indicator_state || scrip->indicator_state_len != state_len || done > n) {
+        for (size_t c = 0; c < MAX_INDICATOR_COLUMNS; ++c) scrip->indicator_data_arrays[c].count = 0;
+        free(scrip->indicator_state);
+        scrip->indicator_state = calloc(state_len, sizeof(double));
+        scrip->indicator_state_len = scrip->indicator_state ? state_len : 0;
+        if (!scrip->indicator_state) {
+            perror("❌ Failed to allocate indicator state");
+            return false;
+        }
+        done = 0;
+    }
+    if (done == n) return true;
+
+    float *out[MAX_INDICATOR_COLUMNS];
+    for (size_t c = 0; c < num_columns; ++c) {
+        if (!reserve_float_array(&scrip->indicator_data_arrays[c], n)) return false;
+        out[c] = scrip->indicator_data_arrays[c].data;
+    }
+
+    // A close column absent from the source was written as zeros, so the indicators see zeros too.
+    const FloatArray *close_column = &scrip->float_data_arrays[FLOAT_FIELD_CLOSE];
+    float *zeros = NULL;
+    const float *close = close_column->data;
+    if (close_column->count < n) {
+        zeros = calloc(n, sizeof(float));
+        if (!zeros) {
+            perror("❌ Failed to allocate zero close column");
+            return false;
+        }
+        close = zeros;
+    }
+
+    double *st = scrip->indicator_state;
+    size_t column = 0;
+    for (uint32_t i = 0; i < layout->indicator_count; ++i) {
+        const IndicatorSpec *spec = &layout->indicators[i];
+        kernel_for(spec)(spec, st, close, done, n, &out[column]);
+        st += indicator_state_doubles(spec);
+        column += indicator_column_count(spec);
+    }
+    for (size_t c = 0; c < num_columns; ++c) scrip->indicator_data_arrays[c].count = n;
+    free(zeros);
+    return true;
+}
+
+bool parse_indicator_specs(const char *text, IndicatorSpec *out_specs, uint32_t *out_count) {
+    *out_count = 0;
+    if (strcmp(text, "none") == 0) return true;
+
+    char buffer[512];
+    if (strlen(text) >= sizeof(buffer)) {
+        fprintf(stderr, "❌ Indicator list too long: %s\n", text);
+        return false;
+    }
+    strcpy(buffer, text);
+
+    char *save = NULL;
+    for (char *item = strtok_r(buffer, ",", &save); item; item = strtok_r(NULL, ",", &save)) {
+        if (*out_count >= MAX_INDICATORS) {
+            fprintf(stderr, "❌ At most %d indicators are supported\n", MAX_INDICATORS);
+            return false;
+        }
+        IndicatorSpec *spec = &out_specs[*out_count];
+        memset(spec, 0, sizeof(*spec));
+
+        // name:period[:stddevs]
+        char *colon = strchr(item, ':');
+        if (!colon || colon == item || (size_t)(colon - item) >= 8) {
+            fprintf(stderr, "❌ Invalid indicator '%s', expected name:period[:stddevs]\n", item);
+            return false;
+        }
+        char name[8];
+        memcpy(name, item, (size_t)(colon - item));
+        name[colon - item] = '\0';
+        // Every character of the item must be consumed: "ema:5junk" is an error, not ema:5.
+        char *end;
+        unsigned long period = strtoul(colon + 1, &end, 10);
+        bool valid = isdigit((unsigned char)colon[1]);
+        bool has_stddev = valid && *end == ':';
+        float num_stddev = 2.0f;
+        if (has_stddev) {
+            const char *stddev_text = end + 1;
+            num_stddev = strtof(stddev_text, &end);
+            valid = end != stddev_text;
+        }
+        if (!valid || *end != '\0') {
+            fprintf(stderr, "❌ Invalid indicator '%s', expected name:period[:stddevs]\n", item);
+            return false;
+        }
+        if (strcmp(name, "sma") == 0) spec->kind = INDICATOR_SMA;
+        else if (strcmp(name, "ema") == 0) spec->kind = INDICATOR_EMA;
+        else if (strcmp(name, "rsi") == 0) spec->kind = INDICATOR_RSI;
+        else if (strcmp(name, "bb") == 0) spec->kind = INDICATOR_BOLLINGER;
+        else {
+            fprintf(stderr, "❌ Unknown indicator '%s' (expected sma, ema, rsi or bb)\n", name);
+            return false;
+        }
+        if ((spec->kind != INDICATOR_BOLLINGER && has_stddev) || !(num_stddev > 0 && num_stddev <= 100)) {
+            fprintf(stderr, "❌ Invalid indicator '%s'\n", item);
+            return false;
+        }
+        if (period == 0 || period > MAX_INDICATOR_PERIOD) {
+            fprintf(stderr, "❌ Indicator period in '%s' must be between 1 and %d\n", item, MAX_INDICATOR_PERIOD);
+            return false;
+        }
+        spec->period = (uint32_t)period;
+        if (spec->kind == INDICATOR_BOLLINGER) spec->num_stddev = num_stddev;
+        (*out_count)++;
+    }
+    return true;
+}
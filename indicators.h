@@ -0,0 +1,24 @@
+#ifndef INDICATORS_H
+#define INDICATORS_H
+
+#include "data_structures.h" // For ScripInfo
+#include "schema.h"          // For IndicatorSpec, FileSchema
+#include <stdbool.h>
+#include <stdint.h>
+
+// --- Derived indicator columns ---
+// Indicators are computed over the close column right after a scrip is parsed
+// and written as extra float32 columns (see schema.h). Each kernel is a
+// streaming update with O(1) work per bar, driven by a rolling state kept with
+// the scrip, so extending a series by new bars resumes from that state and
+// gives the same values as recomputing its whole history.
+
+// Parses a comma-separated list such as "sma:20,ema:12,rsi:14,bb:20:2"
+// (Bollinger defaults to 2 standard deviations). "none" selects no indicators.
+bool parse_indicator_specs(const char *text, IndicatorSpec *out_specs, uint32_t *out_count);
+// Computes the indicator values of the scrip's bars that its indicator
+// columns do not cover yet, for the indicators of layout. Starts over from the
+// first bar when the scrip has no state for this layout.
+bool update_scrip_indicators(const FileSchema *layout, ScripInfo *scrip);
+
+#endif // INDICATORS_H
@@ -2,89 +2,338 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
-// #include <minizip/unzip.h> // No longer needed directly here
-// #include <float.h>        // No longer needed directly here
-// #include <ctype.h>        // No longer needed directly here
-// #include <stdbool.h>      // No longer needed directly here (included by others)
-// #include <limits.h>       // No longer needed directly here
-// #include <stdint.h>       // No longer needed directly here (included by others)
+#include <ctype.h>  // For isdigit
+#include <errno.h>
+#include <stdint.h> // For SIZE_MAX
 
 #include "utils.h"
 #include "data_structures.h"
 #include "zip_parser.h"
 #include "binary_io.h"
+#include "spill.h"
+#include "verify.h"
+#include "scan.h"
+#include "arrow_export.h"
+#include "check.h"
+#include "indicators.h"
+#include "query_protocol.h"
+#include "query_server.h"
 
-// #define INITIAL_CAPACITY 100 // Moved to data_structures.h
-// #define LOG_ENABLED false    // Moved to utils.h
+static const char *DEFAULT_OUTPUT_BIN_FILE = "ohlctv_values_v2.bin";
+static const char *DEFAULT_VERIFICATION_TXT_FILE = "verification_output.txt";
+static const char *DEFAULT_ARROW_FILE = "ohlctv_values.arrow";
 
-// --- Timing ---
-// clock_t lastTime; // Moved to utils.c (declared extern in utils.h)
-// void printTimeSpent(const char *tag); // Moved to utils.h/utils.c
+static void print_usage(const char *prog) {
+    fprintf(stderr,
+            "Usage:\n"
+            "  %s ingest <zip> [out.bin] [--memory-budget-mb N] [--spill-dir DIR] [--indicators LIST]\n"
+            "  %s dump [in.bin] [out.txt]\n"
+            "  %s verify <zip> [in.bin] [--threads N]\n"
+            "  %s serve [in.bin] [--socket PATH] [--workers N] [--lazy-verify]\n"
+            "  %s scan [in.bin] --where key:min:max [--where ...]\n"
+            "  %s arrow [in.bin] [out.arrow]\n"
+            "  %s convert <in.bin> <out.bin> [--memory-budget-mb N] [--spill-dir DIR] [--indicators LIST]\n"
+            "  %s check [in.bin] [--threads N]\n"
+            "  %s extend <in.bin> <zip> <out.bin>\n"
+            "Indicator LIST: comma-separated sma:N, ema:N, rsi:N, bb:N[:K], or none\n",
+            prog, prog, prog, prog, prog, prog, prog, prog, prog);
+}
 
-// All other functions (FloatArray, LongArray, ScripInfoArray helpers,
-// JSON parsing, zip reading, binary writing/reading) have been moved
-// to their respective .c files.
+// Parses a --memory-budget-mb value: digits only, and small enough that the
+// budget in bytes fits a size_t. 0 means no budget.
+static bool parse_memory_budget_mb(const char *text, size_t *out_mb) {
+    char *end;
+    errno = 0;
+    unsigned long long mb = strtoull(text, &end, 10);
+    if (!isdigit((unsigned char)text[0]) || *end != '\0' || errno == ERANGE || mb > SIZE_MAX / (1024 * 1024)) {
+        fprintf(stderr, "❌ Invalid memory budget '%s', expected a number of MB\n", text);
+        return false;
+    }
+    *out_mb = (size_t)mb;
+    return true;
+}
 
-int main(int argc, char *argv[]) {
-    lastTime = clock(); // Initialize lastTime from utils.h
+static int run_ingest(int argc, char *argv[]) {
+    const char *zip_file_path = NULL;
+    const char *output_bin_file = DEFAULT_OUTPUT_BIN_FILE;
+    size_t memory_budget_mb = 0;
+    const char *spill_dir = NULL;
+    IndicatorSpec indicators[MAX_INDICATORS];
+    uint32_t indicator_count = 0;
+    int positional = 0;
 
-    // const char *zip_file_path = "/Users/shakir/BhavAppData/DATA/TEST/1D_ALL_JSON_MoneyControl.zip";
-     const char *output_bin_file = "ohlctv_values_v2.bin";
-     const char *verification_txt_file = "verification_output.txt";
-    //
-    // if (argc > 1) {
-    //     zip_file_path = argv[1];
-    // }
-    // if (argc > 2) {
-    //     output_bin_file = argv[2];
-    // }
-    // if (argc > 3) {
-    //     verification_txt_file = argv[3];
-    // }
-    //
-    // printf("Processing Zip: %s\n", zip_file_path);
-    // printf("Output Binary: %s\n", output_bin_file);
-    // printf("Verification Text Output: %s\n", verification_txt_file);
-    //
-    // ScripInfoArray all_scrips_data;
-    // init_scrip_info_array(&all_scrips_data);
-    // printTimeSpent("Initialization");
-    //
-    // read_zip_and_parse_data(zip_file_path, &all_scrips_data);
-    // printTimeSpent("Parsing all JSON files from ZIP");
-    //
-    // size_t scrips_to_write_count = all_scrips_data.count;
-    //
-    // if (scrips_to_write_count > 0) {
-    //     if (write_binary_two_pass(output_bin_file, &all_scrips_data)) {
-    //         printf("✅ Successfully wrote binary data to %s for %zu scrips.\n", output_bin_file, scrips_to_write_count);
-    //     } else {
-    //         fprintf(stderr, "❌ Failed to write binary data to %s\n", output_bin_file);
-    //     }
-    // } else {
-    //     printf("ℹ️ No scrip data extracted from the zip file. Binary file not written.\n");
-    // }
-    // printTimeSpent("Writing binary file (2-pass)");
-    //
-    // free_scrip_info_array(&all_scrips_data);
-    // printTimeSpent("Cleanup after writing");
-
-
-        printf("\n--- Writing Verification Data to: %s ---\n", verification_txt_file);
-        FILE *verification_file = fopen(verification_txt_file, "w");
-        if (!verification_file) {
-            perror("❌ Failed to open verification text file for writing");
-        } else {
-            read_and_print_binary_data_to_file(output_bin_file, verification_file);
-            if (fclose(verification_file) != 0) {
-                perror("❌ Failed to close verification text file");
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--memory-budget-mb") == 0 && i + 1 < argc) {
+            if (!parse_memory_budget_mb(argv[++i], &memory_budget_mb)) {
+                print_usage(argv[0]);
+                return 2;
             }
-            printf("✅ Verification data written to %s\n", verification_txt_file);
+        } else if (strcmp(argv[i], "--spill-dir") == 0 && i + 1 < argc) {
+            spill_dir = argv[++i];
+        } else if (strcmp(argv[i], "--indicators") == 0 && i + 1 < argc) {
+            if (!parse_indicator_specs(argv[++i], indicators, &indicator_count)) return 2;
+        } else if (positional == 0) {
+            zip_file_path = argv[i]; positional++;
+        } else if (positional == 1) {
+            output_bin_file = argv[i]; positional++;
+        } else {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!zip_file_path) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    printf("Processing Zip: %s\n", zip_file_path);
+    printf("Output Binary: %s\n", output_bin_file);
+    if (memory_budget_mb > 0) printf("Memory budget: %zu MB\n", memory_budget_mb);
+
+    FileSchema layout;
+    if (!compiled_file_schema(&layout, indicators, indicator_count)) return 2;
+    if (indicator_count > 0) printf("Indicators: %u, adding %u columns\n", indicator_count, layout.field_count - layout.first_indicator_field);
+
+    ScripInfoArray all_scrips_data;
+    init_scrip_info_array(&all_scrips_data);
+    SpillStore spill;
+    init_spill_store(&spill, memory_budget_mb * 1024 * 1024, spill_dir);
+    printTimeSpent("Initialization");
+
+    read_zip_and_parse_data(zip_file_path, &layout, &all_scrips_data, &spill);
+    printTimeSpent("Parsing all JSON files from ZIP");
+
+    size_t scrips_to_write_count = all_scrips_data.count;
+    bool ok = true;
+
+    if (scrips_to_write_count > 0) {
+        if (write_binary_two_pass(output_bin_file, &layout, &all_scrips_data, &spill)) {
+            printf("✅ Successfully wrote binary data to %s for %zu scrips.\n", output_bin_file, scrips_to_write_count);
+        } else {
+            fprintf(stderr, "❌ Failed to write binary data to %s\n", output_bin_file);
+            ok = false;
         }
-        printTimeSpent("Writing verification data to text file");
+    } else {
+        printf("ℹ️ No scrip data extracted from the zip file. Binary file not written.\n");
+    }
+    printTimeSpent("Writing binary file (2-pass)");
+
+    free_scrip_info_array(&all_scrips_data);
+    close_spill_store(&spill);
+    printTimeSpent("Cleanup after writing");
 
+    printf("\nTotal scrips processed for writing stage: %zu\n", scrips_to_write_count);
+    printf("📈 Peak RSS: %.2f MB, spilled: %.2f MB in %zu scrips\n",
+           (double)getPeakRssBytes() / (1024.0 * 1024.0),
+           (double)spill.bytes_spilled / (1024.0 * 1024.0), spill.scrips_spilled);
+    return ok ? 0 : 1;
+}
 
-   // printf("\nTotal scrips processed for writing stage: %zu\n", scrips_to_write_count);
+static int run_dump(int argc, char *argv[]) {
+    const char *input_bin_file = argc > 2 ? argv[2] : DEFAULT_OUTPUT_BIN_FILE;
+    const char *verification_txt_file = argc > 3 ? argv[3] : DEFAULT_VERIFICATION_TXT_FILE;
 
+    printf("\n--- Writing Verification Data to: %s ---\n", verification_txt_file);
+    FILE *verification_file = fopen(verification_txt_file, "w");
+    if (!verification_file) {
+        perror("❌ Failed to open verification text file for writing");
+        return 1;
+    }
+    read_and_print_binary_data_to_file(input_bin_file, verification_file);
+    if (fclose(verification_file) != 0) {
+        perror("❌ Failed to close verification text file");
+        return 1;
+    }
+    printf("✅ Verification data written to %s\n", verification_txt_file);
+    printTimeSpent("Writing verification data to text file");
     return 0;
-}
\ No newline at end of file
+}
+
+static int run_verify_mode(int argc, char *argv[]) {
+    const char *zip_file_path = NULL;
+    const char *input_bin_file = DEFAULT_OUTPUT_BIN_FILE;
+    int num_threads = 0;
+    int positional = 0;
+
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            num_threads = atoi(argv[++i]);
+        } else if (positional == 0) {
+            zip_file_path = argv[i]; positional++;
+        } else if (positional == 1) {
+            input_bin_file = argv[i]; positional++;
+        } else {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!zip_file_path) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    int rc = run_verify(zip_file_path, input_bin_file, num_threads);
+    printTimeSpent("Verifying binary file against zip");
+    return rc;
+}
+
+static int run_serve(int argc, char *argv[]) {
+    const char *input_bin_file = DEFAULT_OUTPUT_BIN_FILE;
+    const char *socket_path = QUERY_DEFAULT_SOCKET_PATH;
+    int num_workers = 0;
+    bool lazy_verify = false;
+
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            socket_path = argv[++i];
+        } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            num_workers = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--lazy-verify") == 0) {
+            lazy_verify = true;
+        } else {
+            input_bin_file = argv[i];
+        }
+    }
+    return run_query_server(input_bin_file, socket_path, num_workers, lazy_verify);
+}
+
+static int run_scan_mode(int argc, char *argv[]) {
+    const char *input_bin_file = DEFAULT_OUTPUT_BIN_FILE;
+    const char **specs = calloc((size_t)argc, sizeof(const char *));
+    size_t num_specs = 0;
+    if (!specs) {
+        perror("❌ Failed to allocate scan specs");
+        return 1;
+    }
+
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--where") == 0 && i + 1 < argc) {
+            specs[num_specs++] = argv[++i];
+        } else {
+            input_bin_file = argv[i];
+        }
+    }
+    if (num_specs == 0) {
+        free(specs);
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    int rc = run_scan(input_bin_file, specs, num_specs);
+    free(specs);
+    printTimeSpent("Scanning binary file");
+    return rc;
+}
+
+static int run_arrow_export(int argc, char *argv[]) {
+    const char *input_bin_file = argc > 2 ? argv[2] : DEFAULT_OUTPUT_BIN_FILE;
+    const char *arrow_file = argc > 3 ? argv[3] : DEFAULT_ARROW_FILE;
+
+    bool ok = export_arrow_ipc(input_bin_file, arrow_file);
+    printTimeSpent("Exporting Arrow IPC file");
+    return ok ? 0 : 1;
+}
+
+static int run_convert(int argc, char *argv[]) {
+    const char *input_bin_file = NULL;
+    const char *output_bin_file = NULL;
+    size_t memory_budget_mb = 0;
+    const char *spill_dir = NULL;
+    IndicatorSpec indicators[MAX_INDICATORS];
+    uint32_t indicator_count = 0;
+    bool replace_indicators = false;
+
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--memory-budget-mb") == 0 && i + 1 < argc) {
+            if (!parse_memory_budget_mb(argv[++i], &memory_budget_mb)) {
+                print_usage(argv[0]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--spill-dir") == 0 && i + 1 < argc) {
+            spill_dir = argv[++i];
+        } else if (strcmp(argv[i], "--indicators") == 0 && i + 1 < argc) {
+            if (!parse_indicator_specs(argv[++i], indicators, &indicator_count)) return 2;
+            replace_indicators = true;
+        } else if (!input_bin_file) {
+            input_bin_file = argv[i];
+        } else if (!output_bin_file) {
+            output_bin_file = argv[i];
+        } else {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!input_bin_file || !output_bin_file) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    SpillStore spill;
+    init_spill_store(&spill, memory_budget_mb * 1024 * 1024, spill_dir);
+    bool ok = convert_binary_file(input_bin_file, output_bin_file,
+                                  replace_indicators ? indicators : NULL, indicator_count, &spill);
+    close_spill_store(&spill);
+    if (ok) printf("✅ Converted %s to %s\n", input_bin_file, output_bin_file);
+    printTimeSpent("Converting binary file");
+    return ok ? 0 : 1;
+}
+
+static int run_check_mode(int argc, char *argv[]) {
+    const char *input_bin_file = DEFAULT_OUTPUT_BIN_FILE;
+    int num_threads = 0;
+
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            num_threads = atoi(argv[++i]);
+        } else {
+            input_bin_file = argv[i];
+        }
+    }
+    return run_check(input_bin_file, num_threads);
+}
+
+static int run_extend(int argc, char *argv[]) {
+    if (argc != 5) {
+        print_usage(argv[0]);
+        return 2;
+    }
+    bool ok = extend_binary_file(argv[2], argv[3], argv[4]);
+    if (ok) printf("✅ Extended %s with %s into %s\n", argv[2], argv[3], argv[4]);
+    printTimeSpent("Extending binary file");
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char *argv[]) {
+    lastTime = clock(); // Initialize lastTime from utils.h
+
+    // Without a mode, keep the old behaviour of dumping the default binary file.
+    if (argc < 2 || strcmp(argv[1], "dump") == 0) {
+        return run_dump(argc, argv);
+    }
+    if (strcmp(argv[1], "ingest") == 0) {
+        return run_ingest(argc, argv);
+    }
+    if (strcmp(argv[1], "verify") == 0) {
+        return run_verify_mode(argc, argv);
+    }
+    if (strcmp(argv[1], "serve") == 0) {
+        return run_serve(argc, argv);
+    }
+    if (strcmp(argv[1], "scan") == 0) {
+        return run_scan_mode(argc, argv);
+    }
+    if (strcmp(argv[1], "arrow") == 0) {
+        return run_arrow_export(argc, argv);
+    }
+    if (strcmp(argv[1], "convert") == 0) {
+        return run_convert(argc, argv);
+    }
+    if (strcmp(argv[1], "check") == 0) {
+        return run_check_mode(argc, argv);
+    }
+    if (strcmp(argv[1], "extend") == 0) {
+        return run_extend(argc, argv);
+    }
+    print_usage(argv[0]);
+    return 2;
+}
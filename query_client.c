@@ -0,0 +1,143 @@
+#include "query_client.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // macOS: callers should ignore SIGPIPE themselves
+#endif
+
+bool query_client_connect(QueryClient *qc, const char *socket_path) {
+    struct sockaddr_un addr;
+    qc->fd = -1;
+    if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "❌ Socket path too long: %s\n", socket_path);
+        return false;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1) {
+        perror("❌ Failed to create client socket");
+        return false;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socket_path);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        perror("❌ Failed to connect to query server");
+        close(fd);
+        return false;
+    }
+    qc->fd = fd;
+    return true;
+}
+
+void query_client_close(QueryClient *qc) {
+    if (qc->fd != -1) close(qc->fd);
+    qc->fd = -1;
+}
+
+static bool read_full(int fd, void *buf, size_t len) {
+    size_t got = 0;
+    while (got < len) {
+        ssize_t n = read(fd, (char *)buf + got, len - got);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        got += (size_t)n;
+    }
+    return true;
+}
+
+static bool send_request(QueryClient *qc, const QueryRequest *req, const char *symbol) {
+    struct iovec iov[2] = { { (void *)req, sizeof(*req) }, { (void *)symbol, req->symbol_len } };
+    int iov_count = req->symbol_len > 0 ? 2 : 1;
+    size_t total = sizeof(*req) + req->symbol_len;
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iov_count;
+    ssize_t n = sendmsg(qc->fd, &msg, MSG_NOSIGNAL);
+    // Requests are tiny; a short write on a local stream socket means trouble.
+    if (n != (ssize_t)total) {
+        perror("❌ Failed to send query request");
+        return false;
+    }
+    return true;
+}
+
+static bool read_response_header(QueryClient *qc, QueryResponseHeader *hdr) {
+    if (!read_full(qc->fd, hdr, sizeof(*hdr))) {
+        fprintf(stderr, "❌ Query server closed the connection\n");
+        return false;
+    }
+    if (hdr->magic != QUERY_MAGIC) {
+        fprintf(stderr, "❌ Bad magic in query response\n");
+        return false;
+    }
+    return true;
+}
+
+bool query_client_fetch(QueryClient *qc, const char *symbol, int64_t t_from, int64_t t_to,
+                        uint64_t column_mask, QueryResult *out) {
+    memset(out, 0, sizeof(*out));
+    size_t symbol_len = strlen(symbol);
+    if (symbol_len > QUERY_MAX_SYMBOL_LEN) {
+        fprintf(stderr, "❌ Symbol too long: %s\n", symbol);
+        return false;
+    }
+    QueryRequest req = { QUERY_MAGIC, QUERY_OP_FETCH, (uint16_t)symbol_len, column_mask, t_from, t_to };
+    if (!send_request(qc, &req, symbol)) return false;
+
+    QueryResponseHeader hdr;
+    if (!read_response_header(qc, &hdr)) return false;
+    out->status = hdr.status;
+    out->row_count = hdr.row_count;
+    out->column_mask = hdr.column_mask;
+    out->payload_bytes = (size_t)hdr.payload_bytes;
+    if (hdr.payload_bytes == 0) return true;
+
+    out->payload = malloc(out->payload_bytes);
+    if (!out->payload) {
+        perror("❌ Failed to allocate query result");
+        return false;
+    }
+    if (!read_full(qc->fd, out->payload, out->payload_bytes)) {
+        fprintf(stderr, "❌ Truncated query response\n");
+        query_result_free(out);
+        return false;
+    }
+    size_t offset = 0;
+    for (int i = 0; i < QUERY_MAX_COLUMNS; ++i) {
+        if (!(hdr.column_mask & (1ULL << i))) continue;
+        size_t width = i < TOTAL_KEYS_CONST ? COMPILED_SCHEMA_FIELDS[i].width : sizeof(float);
+        out->columns[i] = out->payload + offset;
+        offset += (size_t)hdr.row_count * width;
+    }
+    if (offset != out->payload_bytes) {
+        fprintf(stderr, "❌ Query response size %zu does not match its columns (%zu)\n", out->payload_bytes, offset);
+        query_result_free(out);
+        return false;
+    }
+    return true;
+}
+
+void query_result_free(QueryResult *result) {
+    free(result->payload);
+    memset(result, 0, sizeof(*result));
+}
+
+bool query_client_stats(QueryClient *qc, QueryServerStats *out) {
+    QueryRequest req = { QUERY_MAGIC, QUERY_OP_STATS, 0, 0, 0, 0 };
+    if (!send_request(qc, &req, "")) return false;
+    QueryResponseHeader hdr;
+    if (!read_response_header(qc, &hdr)) return false;
+    if (hdr.status != QUERY_STATUS_OK || hdr.payload_bytes != sizeof(*out)) {
+        fprintf(stderr, "❌ Unexpected stats response (status %d)\n", hdr.status);
+        return false;
+    }
+    return read_full(qc->fd, out, sizeof(*out));
+}
@@ -0,0 +1,47 @@
+#ifndef QUERY_CLIENT_H
+#define QUERY_CLIENT_H
+
+#include "query_protocol.h"
+#include "schema.h" // For TOTAL_KEYS_CONST, MAX_INDICATOR_COLUMNS
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// --- Client for the local query daemon ---
+// One connection can carry any number of sequential requests.
+
+typedef struct {
+    int fd;
+} QueryClient;
+
+typedef struct {
+    int32_t status;       // QUERY_STATUS_*
+    uint64_t row_count;
+    uint64_t column_mask; // Columns actually returned
+    unsigned char *payload;
+    size_t payload_bytes;
+    // Start of each returned column inside payload, NULL if not returned.
+    // Slices are packed back to back, so use memcpy for typed access.
+    const unsigned char *columns[QUERY_MAX_COLUMNS];
+} QueryResult;
+
+_Static_assert(TOTAL_KEYS_CONST + MAX_INDICATOR_COLUMNS <= QUERY_MAX_COLUMNS, "column_mask has a bit per column");
+
+#define QUERY_ALL_COLUMNS ((1ULL << TOTAL_KEYS_CONST) - 1) // Every compiled field
+// k-th indicator column of the served file; its slice holds float32 values.
+#define QUERY_INDICATOR_COLUMN(k) (1ULL << (TOTAL_KEYS_CONST + (k)))
+#define QUERY_ALL_INDICATOR_COLUMNS (~QUERY_ALL_COLUMNS)
+
+bool query_client_connect(QueryClient *qc, const char *socket_path);
+void query_client_close(QueryClient *qc);
+
+// Fetches rows of symbol with t_from <= timestamp <= t_to (use INT64_MIN /
+// INT64_MAX for an open range). Returns false on transport errors only; a
+// missing symbol comes back as out->status == QUERY_STATUS_NOT_FOUND.
+bool query_client_fetch(QueryClient *qc, const char *symbol, int64_t t_from, int64_t t_to,
+                        uint64_t column_mask, QueryResult *out);
+void query_result_free(QueryResult *result);
+
+bool query_client_stats(QueryClient *qc, QueryServerStats *out);
+
+#endif // QUERY_CLIENT_H
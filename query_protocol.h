@@ -0,0 +1,67 @@
+#ifndef QUERY_PROTOCOL_H
+#define QUERY_PROTOCOL_H
+
+#include <stdint.h>
+
+// --- Wire protocol of the local query daemon (Unix-domain stream socket) ---
+// Native byte order: client and server always run on the same host.
+//
+// Request:  QueryRequest, then symbol_len bytes of scrip name.
+// Response: QueryResponseHeader, then payload_bytes of payload. For
+//           QUERY_OP_FETCH the payload is one slice per column in column_mask,
+//           in schema order, each row_count * field width bytes. For
+//           QUERY_OP_STATS it is a QueryServerStats.
+//
+// Column mask bit i < TOTAL_KEYS_CONST selects COMPILED_SCHEMA_FIELDS[i]; bit
+// TOTAL_KEYS_CONST + k selects the served file's k-th indicator column (float32,
+// in the order of the --indicators list it was built with; `dump` lists each
+// indicator column with its bit). Time bounds are inclusive and compared
+// against the "t" column, which the server binary-searches: ingest and extend
+// only store strictly increasing timestamps.
+
+#define QUERY_MAGIC 0x51444f43u // "CODQ"
+#define QUERY_MAX_SYMBOL_LEN 100
+#define QUERY_MAX_COLUMNS 64 // Bits in column_mask
+#define QUERY_DEFAULT_SOCKET_PATH "/tmp/cdo_query.sock"
+
+enum {
+    QUERY_OP_FETCH = 1,
+    QUERY_OP_STATS = 2
+};
+
+enum {
+    QUERY_STATUS_OK = 0,
+    QUERY_STATUS_BAD_REQUEST = 1,
+    QUERY_STATUS_NOT_FOUND = 2,
+    QUERY_STATUS_UNAVAILABLE = 3,
+    QUERY_STATUS_CORRUPT = 4 // Block failed its checksum (server run with --lazy-verify)
+};
+
+typedef struct {
+    uint32_t magic;
+    uint16_t op;
+    uint16_t symbol_len;
+    uint64_t column_mask;
+    int64_t t_from;
+    int64_t t_to;
+} QueryRequest;
+
+typedef struct {
+    uint32_t magic;
+    int32_t status;
+    uint64_t row_count;
+    uint64_t column_mask;
+    uint64_t payload_bytes;
+} QueryResponseHeader;
+
+typedef struct {
+    uint64_t requests;
+    uint64_t errors;
+    uint64_t reloads;
+    uint64_t bytes_sent;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t max_ns;
+} QueryServerStats;
+
+#endif // QUERY_PROTOCOL_H
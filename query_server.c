@@ -0,0 +1,608 @@
+#ifdef __linux__
+#define _GNU_SOURCE // For accept4
+#endif
+#include "query_server.h"
+#include <stdio.h>
+
+#ifdef __linux__
+
+#include "bin_reader.h"
+#include "query_protocol.h"
+#include "schema.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+
+#define QUERY_MAX_EVENTS 64
+#define QUERY_EPOLL_TIMEOUT_MS 500
+#define QUERY_RELOAD_CHECK_NS 1000000000ULL
+#define QUERY_CLIENT_RECV_TIMEOUT_SEC 2
+#define QUERY_CLIENT_SEND_TIMEOUT_SEC 5 // Whole response, not per sendmsg call
+
+// Log-linear latency histogram: 8 sub-buckets per power of two nanoseconds.
+#define LATENCY_SUB_BUCKET_BITS 3
+#define LATENCY_SUB_BUCKETS (1 << LATENCY_SUB_BUCKET_BITS)
+#define LATENCY_BUCKETS (64 * LATENCY_SUB_BUCKETS)
+
+typedef struct {
+    BinFile bf;
+    int field_column[QUERY_MAX_COLUMNS]; // File column per column mask bit, -1 if not servable
+    int timestamp_column;
+    struct stat st;
+    atomic_int refs;
+} ServedFile;
+
+typedef struct {
+    const char *bin_path;
+    bool lazy_verify; // Check each block's CRC the first time it is served
+    int epoll_fd;
+
+    pthread_mutex_t file_lock;
+    ServedFile *current;
+    uint64_t last_reload_check_ns;
+
+    pthread_mutex_t queue_lock;
+    pthread_cond_t queue_cond;
+    int *ready_fds; // Ring buffer of clients with a pending request
+    size_t ready_head;
+    size_t ready_count;
+    size_t ready_capacity;
+    bool stopping;
+
+    atomic_uint_fast64_t requests;
+    atomic_uint_fast64_t errors;
+    atomic_uint_fast64_t reloads;
+    atomic_uint_fast64_t bytes_sent;
+    atomic_uint_fast64_t max_ns;
+    atomic_uint_fast64_t latency_hist[LATENCY_BUCKETS];
+} QueryServer;
+
+static volatile sig_atomic_t stop_requested = 0;
+static volatile sig_atomic_t reload_requested = 0;
+
+static void handle_stop_signal(int sig) { (void)sig; stop_requested = 1; }
+static void handle_reload_signal(int sig) { (void)sig; reload_requested = 1; }
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// --- Latency accounting ---
+static size_t latency_bucket(uint64_t ns) {
+    if (ns < LATENCY_SUB_BUCKETS) return (size_t)ns;
+    int msb = 63 - __builtin_clzll(ns);
+    size_t sub = (size_t)(ns >> (msb - LATENCY_SUB_BUCKET_BITS)) & (LATENCY_SUB_BUCKETS - 1);
+    return (size_t)(msb - LATENCY_SUB_BUCKET_BITS + 1) * LATENCY_SUB_BUCKETS + sub;
+}
+
+// Largest latency that falls into the bucket.
+static uint64_t latency_bucket_upper_ns(size_t bucket) {
+    if (bucket < LATENCY_SUB_BUCKETS) return bucket;
+    int msb = (int)(bucket / LATENCY_SUB_BUCKETS) + LATENCY_SUB_BUCKET_BITS - 1;
+    uint64_t sub = bucket % LATENCY_SUB_BUCKETS;
+    uint64_t width = 1ULL << (msb - LATENCY_SUB_BUCKET_BITS);
+    return ((LATENCY_SUB_BUCKETS + sub) << (msb - LATENCY_SUB_BUCKET_BITS)) + width - 1;
+}
+
+static void record_latency(QueryServer *srv, uint64_t ns) {
+    atomic_fetch_add(&srv->latency_hist[latency_bucket(ns)], 1);
+    uint_fast64_t prev = atomic_load(&srv->max_ns);
+    while (ns > prev && !atomic_compare_exchange_weak(&srv->max_ns, &prev, ns)) {
+    }
+}
+
+static uint64_t latency_percentile_ns(QueryServer *srv, double q) {
+    uint64_t counts[LATENCY_BUCKETS];
+    uint64_t total = 0;
+    for (size_t i = 0; i < LATENCY_BUCKETS; ++i) {
+        counts[i] = atomic_load(&srv->latency_hist[i]);
+        total += counts[i];
+    }
+    if (total == 0) return 0;
+    uint64_t target = (uint64_t)(q * (double)total);
+    if (target == 0) target = 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < LATENCY_BUCKETS; ++i) {
+        seen += counts[i];
+        if (seen >= target) return latency_bucket_upper_ns(i);
+    }
+    return latency_bucket_upper_ns(LATENCY_BUCKETS - 1);
+}
+
+static void fill_stats(QueryServer *srv, QueryServerStats *stats) {
+    stats->requests = atomic_load(&srv->requests);
+    stats->errors = atomic_load(&srv->errors);
+    stats->reloads = atomic_load(&srv->reloads);
+    stats->bytes_sent = atomic_load(&srv->bytes_sent);
+    stats->p50_ns = latency_percentile_ns(srv, 0.50);
+    stats->p99_ns = latency_percentile_ns(srv, 0.99);
+    stats->max_ns = atomic_load(&srv->max_ns);
+}
+
+// --- Served file lifetime ---
+static ServedFile *served_file_open(const char *path, bool lazy_verify) {
+    ServedFile *f = calloc(1, sizeof(ServedFile));
+    if (!f) {
+        perror("❌ Failed to allocate served file");
+        return NULL;
+    }
+    if (stat(path, &f->st) != 0 || !bin_open(path, &f->bf)) {
+        fprintf(stderr, "❌ Failed to map %s for serving\n", path);
+        free(f);
+        return NULL;
+    }
+    if (lazy_verify && !bin_enable_lazy_verify(&f->bf)) {
+        bin_close(&f->bf);
+        free(f);
+        return NULL;
+    }
+    for (int i = 0; i < TOTAL_KEYS_CONST; ++i) {
+        const FieldDesc *want = &COMPILED_SCHEMA_FIELDS[i];
+        int col = find_schema_field(&f->bf.schema, want->key);
+        if (col >= 0 && (f->bf.schema.fields[col].type != want->type || f->bf.schema.fields[col].width != want->width)) {
+            fprintf(stderr, "⚠️ Field %s has an incompatible width in %s, not serving it\n", want->name, path);
+            col = -1;
+        }
+        f->field_column[i] = col;
+    }
+    // The remaining bits address the indicator columns, which follow the others in the file.
+    for (int i = TOTAL_KEYS_CONST; i < QUERY_MAX_COLUMNS; ++i) {
+        uint32_t col = f->bf.schema.first_indicator_field + (uint32_t)(i - TOTAL_KEYS_CONST);
+        f->field_column[i] = f->bf.schema.indicator_count > 0 && col < f->bf.schema.field_count ? (int)col : -1;
+    }
+    f->timestamp_column = f->field_column[NUM_FLOAT_KEYS_CONST + LONG_FIELD_TIMESTAMP];
+    atomic_init(&f->refs, 1);
+    return f;
+}
+
+static void served_file_release(ServedFile *f) {
+    if (f && atomic_fetch_sub(&f->refs, 1) == 1) {
+        bin_close(&f->bf);
+        free(f);
+    }
+}
+
+static ServedFile *served_file_acquire(QueryServer *srv) {
+    pthread_mutex_lock(&srv->file_lock);
+    ServedFile *f = srv->current;
+    if (f) atomic_fetch_add(&f->refs, 1);
+    pthread_mutex_unlock(&srv->file_lock);
+    return f;
+}
+
+static void maybe_reload(QueryServer *srv) {
+    uint64_t now = monotonic_ns();
+    if (!reload_requested && now - srv->last_reload_check_ns < QUERY_RELOAD_CHECK_NS) return;
+    srv->last_reload_check_ns = now;
+
+    struct stat st;
+    if (stat(srv->bin_path, &st) != 0) return; // Publisher may be mid-rename
+    bool forced = reload_requested;
+    reload_requested = 0;
+    const struct stat *cur = &srv->current->st;
+    if (!forced && st.st_ino == cur->st_ino && st.st_dev == cur->st_dev && st.st_size == cur->st_size &&
+        st.st_mtim.tv_sec == cur->st_mtim.tv_sec && st.st_mtim.tv_nsec == cur->st_mtim.tv_nsec) {
+        return;
+    }
+
+    ServedFile *fresh = served_file_open(srv->bin_path, srv->lazy_verify);
+    if (!fresh) {
+        fprintf(stderr, "⚠️ Keeping previous mapping of %s\n", srv->bin_path);
+        return;
+    }
+    pthread_mutex_lock(&srv->file_lock);
+    ServedFile *old = srv->current;
+    srv->current = fresh;
+    pthread_mutex_unlock(&srv->file_lock);
+    served_file_release(old);
+    atomic_fetch_add(&srv->reloads, 1);
+    printf("🔄 Reloaded %s (%zu scrips)\n", srv->bin_path, fresh->bf.scrip_count);
+}
+
+// --- Socket helpers ---
+// Returns the number of bytes read; less than len only on EOF or error.
+static size_t recv_full(int fd, void *buf, size_t len) {
+    size_t got = 0;
+    while (got < len) {
+        ssize_t n = recv(fd, (char *)buf + got, len - got, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        got += (size_t)n;
+    }
+    return got;
+}
+
+// Gives up once the client has not taken the whole response within
+// QUERY_CLIENT_SEND_TIMEOUT_SEC; SO_SNDTIMEO bounds each blocking sendmsg.
+static bool send_iov_full(int fd, struct iovec *iov, int iov_count) {
+    uint64_t deadline_ns = monotonic_ns() + QUERY_CLIENT_SEND_TIMEOUT_SEC * 1000000000ULL;
+    while (iov_count > 0) {
+        if (monotonic_ns() > deadline_ns) return false;
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = (size_t)iov_count;
+        ssize_t n = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        size_t sent = (size_t)n;
+        while (iov_count > 0 && sent >= iov->iov_len) {
+            sent -= iov->iov_len;
+            iov++;
+            iov_count--;
+        }
+        if (iov_count > 0) {
+            iov->iov_base = (char *)iov->iov_base + sent;
+            iov->iov_len -= sent;
+        }
+    }
+    return true;
+}
+
+static bool send_status(int fd, int32_t status) {
+    QueryResponseHeader hdr = { QUERY_MAGIC, status, 0, 0, 0 };
+    struct iovec iov = { &hdr, sizeof(hdr) };
+    return send_iov_full(fd, &iov, 1);
+}
+
+static int64_t load_timestamp(const unsigned char *col, size_t i) {
+    int64_t v;
+    memcpy(&v, col + i * sizeof(int64_t), sizeof(int64_t));
+    return v;
+}
+
+// First row whose timestamp is >= t (or > t when inclusive_upper). Ingest and
+// extend only store strictly increasing timestamps, so the column is sorted.
+static size_t timestamp_bound(const unsigned char *col, size_t n, int64_t t, bool inclusive_upper) {
+    size_t lo = 0, hi = n;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int64_t v = load_timestamp(col, mid);
+        if (v < t || (inclusive_upper && v == t)) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static bool serve_fetch(QueryServer *srv, int fd, const QueryRequest *req, const char *symbol) {
+    ServedFile *f = served_file_acquire(srv);
+    if (!f) return send_status(fd, QUERY_STATUS_UNAVAILABLE);
+
+    bool ok;
+    long idx = bin_find_scrip(&f->bf, symbol);
+    if (idx < 0) {
+        atomic_fetch_add(&srv->errors, 1);
+        ok = send_status(fd, QUERY_STATUS_NOT_FOUND);
+    } else if (f->bf.scrips[idx].num_records == 0) {
+        atomic_fetch_add(&srv->errors, 1);
+        ok = send_status(fd, QUERY_STATUS_UNAVAILABLE);
+    } else if (!bin_touch_scrip(&f->bf, (size_t)idx)) {
+        atomic_fetch_add(&srv->errors, 1);
+        ok = send_status(fd, QUERY_STATUS_CORRUPT);
+    } else {
+        const BinScripEntry *entry = &f->bf.scrips[idx];
+        size_t lo = 0, hi = entry->num_records;
+        if (f->timestamp_column >= 0) {
+            const unsigned char *ts = bin_column(&f->bf, entry, f->timestamp_column);
+            lo = timestamp_bound(ts, entry->num_records, req->t_from, false);
+            hi = timestamp_bound(ts, entry->num_records, req->t_to, true);
+            if (hi < lo) hi = lo;
+        }
+        size_t rows = hi - lo;
+
+        QueryResponseHeader hdr = { QUERY_MAGIC, QUERY_STATUS_OK, rows, 0, 0 };
+        struct iovec iov[1 + QUERY_MAX_COLUMNS];
+        int iov_count = 1;
+        for (int i = 0; i < QUERY_MAX_COLUMNS; ++i) {
+            if (!(req->column_mask & (1ULL << i)) || f->field_column[i] < 0) continue;
+            size_t width = f->bf.schema.fields[f->field_column[i]].width;
+            hdr.column_mask |= 1ULL << i;
+            hdr.payload_bytes += rows * width;
+            // Points straight into the mapping; the kernel copies from page cache.
+            iov[iov_count].iov_base = (void *)(bin_column(&f->bf, entry, f->field_column[i]) + lo * width);
+            iov[iov_count].iov_len = rows * width;
+            iov_count++;
+        }
+        iov[0].iov_base = &hdr;
+        iov[0].iov_len = sizeof(hdr);
+        ok = send_iov_full(fd, iov, iov_count);
+        if (ok) atomic_fetch_add(&srv->bytes_sent, sizeof(hdr) + hdr.payload_bytes);
+    }
+    served_file_release(f);
+    return ok;
+}
+
+// Handles one request. Returns false when the connection should be closed.
+static bool handle_client_request(QueryServer *srv, int fd) {
+    QueryRequest req;
+    if (recv_full(fd, &req, sizeof(req)) != sizeof(req)) return false;
+    uint64_t start_ns = monotonic_ns();
+
+    if (req.magic != QUERY_MAGIC || req.symbol_len > QUERY_MAX_SYMBOL_LEN) {
+        atomic_fetch_add(&srv->errors, 1);
+        send_status(fd, QUERY_STATUS_BAD_REQUEST);
+        return false;
+    }
+    char symbol[QUERY_MAX_SYMBOL_LEN + 1];
+    if (recv_full(fd, symbol, req.symbol_len) != req.symbol_len) return false;
+    symbol[req.symbol_len] = '\0';
+
+    bool ok;
+    if (req.op == QUERY_OP_FETCH) {
+        ok = serve_fetch(srv, fd, &req, symbol);
+    } else if (req.op == QUERY_OP_STATS) {
+        QueryServerStats stats;
+        fill_stats(srv, &stats);
+        QueryResponseHeader hdr = { QUERY_MAGIC, QUERY_STATUS_OK, 0, 0, sizeof(stats) };
+        struct iovec iov[2] = { { &hdr, sizeof(hdr) }, { &stats, sizeof(stats) } };
+        ok = send_iov_full(fd, iov, 2);
+    } else {
+        atomic_fetch_add(&srv->errors, 1);
+        ok = send_status(fd, QUERY_STATUS_BAD_REQUEST);
+    }
+
+    // The response could not be delivered (client gone or not reading); the caller closes the connection.
+    if (!ok) atomic_fetch_add(&srv->errors, 1);
+    atomic_fetch_add(&srv->requests, 1);
+    record_latency(srv, monotonic_ns() - start_ns);
+    return ok;
+}
+
+// --- Worker pool ---
+static bool enqueue_ready_fd(QueryServer *srv, int fd) {
+    pthread_mutex_lock(&srv->queue_lock);
+    if (srv->ready_count == srv->ready_capacity) {
+        size_t new_capacity = srv->ready_capacity ? srv->ready_capacity * 2 : 64;
+        int *temp = malloc(new_capacity * sizeof(int));
+        if (!temp) {
+            pthread_mutex_unlock(&srv->queue_lock);
+            perror("❌ Failed to grow ready queue");
+            return false;
+        }
+        for (size_t i = 0; i < srv->ready_count; ++i) {
+            temp[i] = srv->ready_fds[(srv->ready_head + i) % srv->ready_capacity];
+        }
+        free(srv->ready_fds);
+        srv->ready_fds = temp;
+        srv->ready_head = 0;
+        srv->ready_capacity = new_capacity;
+    }
+    srv->ready_fds[(srv->ready_head + srv->ready_count) % srv->ready_capacity] = fd;
+    srv->ready_count++;
+    pthread_cond_signal(&srv->queue_cond);
+    pthread_mutex_unlock(&srv->queue_lock);
+    return true;
+}
+
+static void *query_worker(void *arg) {
+    QueryServer *srv = arg;
+    for (;;) {
+        pthread_mutex_lock(&srv->queue_lock);
+        while (srv->ready_count == 0 && !srv->stopping) pthread_cond_wait(&srv->queue_cond, &srv->queue_lock);
+        // On shutdown the queue is drained first so no queued client is left hanging.
+        if (srv->ready_count == 0) {
+            pthread_mutex_unlock(&srv->queue_lock);
+            return NULL;
+        }
+        int fd = srv->ready_fds[srv->ready_head];
+        srv->ready_head = (srv->ready_head + 1) % srv->ready_capacity;
+        srv->ready_count--;
+        bool stopping = srv->stopping;
+        pthread_mutex_unlock(&srv->queue_lock);
+
+        if (handle_client_request(srv, fd) && !stopping) {
+            // EPOLLONESHOT: the client is only handed to one worker at a time.
+            struct epoll_event ev;
+            ev.events = EPOLLIN | EPOLLONESHOT;
+            ev.data.fd = fd;
+            if (epoll_ctl(srv->epoll_fd, EPOLL_CTL_MOD, fd, &ev) != 0) close(fd);
+        } else {
+            close(fd);
+        }
+    }
+}
+
+static int open_listen_socket(const char *socket_path) {
+    struct sockaddr_un addr;
+    if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "❌ Socket path too long: %s\n", socket_path);
+        return -1;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        perror("❌ Failed to create query socket");
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socket_path);
+
+    // Only a stale socket from a previous run is replaced: never a live
+    // server's socket, nor a file that happens to sit at a mistyped path.
+    struct stat st;
+    if (lstat(socket_path, &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            fprintf(stderr, "❌ %s exists and is not a socket, refusing to replace it\n", socket_path);
+            close(fd);
+            return -1;
+        }
+        int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        bool live = probe != -1 && connect(probe, (struct sockaddr *)&addr, sizeof(addr)) == 0;
+        if (probe != -1) close(probe);
+        if (live) {
+            fprintf(stderr, "❌ A server is already listening on %s\n", socket_path);
+            close(fd);
+            return -1;
+        }
+        unlink(socket_path);
+    }
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, SOMAXCONN) != 0) {
+        perror("❌ Failed to bind query socket");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void accept_clients(QueryServer *srv, int listen_fd) {
+    for (;;) {
+        int fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+        if (fd == -1) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) perror("❌ accept failed");
+            return;
+        }
+        // Workers use blocking I/O; the timeouts stop a client that stalls
+        // mid-request or stops reading its response from pinning a worker.
+        struct timeval recv_tv = { QUERY_CLIENT_RECV_TIMEOUT_SEC, 0 };
+        struct timeval send_tv = { QUERY_CLIENT_SEND_TIMEOUT_SEC, 0 };
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &recv_tv, sizeof(recv_tv));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &send_tv, sizeof(send_tv));
+        struct epoll_event ev;
+        ev.events = EPOLLIN | EPOLLONESHOT;
+        ev.data.fd = fd;
+        if (epoll_ctl(srv->epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            perror("❌ Failed to register client");
+            close(fd);
+        }
+    }
+}
+
+int run_query_server(const char *bin_path, const char *socket_path, int num_workers, bool lazy_verify) {
+    if (num_workers <= 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        num_workers = cores > 0 ? (int)cores : 1;
+    }
+
+    QueryServer *srv = calloc(1, sizeof(QueryServer));
+    if (!srv) {
+        perror("❌ Failed to allocate query server");
+        return 1;
+    }
+    srv->bin_path = bin_path;
+    srv->lazy_verify = lazy_verify;
+    srv->current = served_file_open(bin_path, lazy_verify);
+    if (!srv->current) {
+        free(srv);
+        return 1;
+    }
+    srv->last_reload_check_ns = monotonic_ns();
+    pthread_mutex_init(&srv->file_lock, NULL);
+    pthread_mutex_init(&srv->queue_lock, NULL);
+    pthread_cond_init(&srv->queue_cond, NULL);
+
+    int rc = 1;
+    pthread_t *workers = NULL;
+    int started = 0;
+    int listen_fd = open_listen_socket(socket_path);
+    srv->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (listen_fd == -1 || srv->epoll_fd == -1) {
+        if (srv->epoll_fd == -1) perror("❌ epoll_create1 failed");
+        goto cleanup;
+    }
+    struct epoll_event listen_ev;
+    listen_ev.events = EPOLLIN;
+    listen_ev.data.fd = listen_fd;
+    if (epoll_ctl(srv->epoll_fd, EPOLL_CTL_ADD, listen_fd, &listen_ev) != 0) {
+        perror("❌ Failed to register listen socket");
+        goto cleanup;
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_stop_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    sa.sa_handler = handle_reload_signal;
+    sigaction(SIGHUP, &sa, NULL);
+    sa.sa_handler = SIG_IGN;
+    sigaction(SIGPIPE, &sa, NULL);
+
+    workers = malloc((size_t)num_workers * sizeof(pthread_t));
+    if (!workers) {
+        perror("❌ Failed to allocate query workers");
+        goto cleanup;
+    }
+    for (; started < num_workers; ++started) {
+        if (pthread_create(&workers[started], NULL, query_worker, srv) != 0) {
+            perror("❌ Failed to start query worker");
+            break;
+        }
+    }
+    if (started == 0) goto cleanup;
+
+    printf("✅ Serving %s (%zu scrips) on %s with %d workers\n",
+           bin_path, srv->current->bf.scrip_count, socket_path, started);
+    fflush(stdout);
+
+    struct epoll_event events[QUERY_MAX_EVENTS];
+    while (!stop_requested) {
+        int n = epoll_wait(srv->epoll_fd, events, QUERY_MAX_EVENTS, QUERY_EPOLL_TIMEOUT_MS);
+        if (n < 0 && errno != EINTR) {
+            perror("❌ epoll_wait failed");
+            break;
+        }
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == listen_fd) {
+                accept_clients(srv, listen_fd);
+            } else if (!enqueue_ready_fd(srv, fd)) {
+                close(fd);
+            }
+        }
+        maybe_reload(srv);
+    }
+    rc = stop_requested ? 0 : 1;
+
+cleanup:
+    pthread_mutex_lock(&srv->queue_lock);
+    srv->stopping = true;
+    pthread_cond_broadcast(&srv->queue_cond);
+    pthread_mutex_unlock(&srv->queue_lock);
+    for (int i = 0; i < started; ++i) pthread_join(workers[i], NULL);
+    free(workers);
+
+    QueryServerStats stats;
+    fill_stats(srv, &stats);
+    printf("📈 Requests: %llu, errors: %llu, reloads: %llu, p50: %.1f us, p99: %.1f us, max: %.1f us\n",
+           (unsigned long long)stats.requests, (unsigned long long)stats.errors, (unsigned long long)stats.reloads,
+           (double)stats.p50_ns / 1000.0, (double)stats.p99_ns / 1000.0, (double)stats.max_ns / 1000.0);
+
+    if (listen_fd != -1) {
+        close(listen_fd);
+        unlink(socket_path);
+    }
+    if (srv->epoll_fd != -1) close(srv->epoll_fd);
+    served_file_release(srv->current);
+    free(srv->ready_fds);
+    pthread_cond_destroy(&srv->queue_cond);
+    pthread_mutex_destroy(&srv->queue_lock);
+    pthread_mutex_destroy(&srv->file_lock);
+    free(srv);
+    return rc;
+}
+
+#else // !__linux__
+
+int run_query_server(const char *bin_path, const char *socket_path, int num_workers, bool lazy_verify) {
+    (void)bin_path; (void)socket_path; (void)num_workers; (void)lazy_verify;
+    fprintf(stderr, "❌ The query server needs epoll and is only available on Linux\n");
+    return 1;
+}
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef QUERY_SERVER_H
+#define QUERY_SERVER_H
+
+#include <stdbool.h>
+
+// --- Local query daemon ---
+// Maps bin_path once and answers QueryRequests (see query_protocol.h) on a
+// Unix-domain socket. An epoll loop accepts connections and hands readable
+// clients to num_workers threads (<= 0 picks the number of cores), which send
+// column slices straight out of the mapping with sendmsg.
+// The file is re-mapped when a new one is published at bin_path (rename over
+// it, or send SIGHUP); in-flight requests finish on the old mapping.
+// With lazy_verify, each scrip block's checksum is checked the first time it
+// is requested and corrupt blocks are answered with QUERY_STATUS_CORRUPT.
+// Runs until SIGINT/SIGTERM. Returns 0 on clean shutdown. Linux only.
+int run_query_server(const char *bin_path, const char *socket_path, int num_workers, bool lazy_verify);
+
+#endif // QUERY_SERVER_H
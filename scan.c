@@ -0,0 +1,113 @@
+#include "scan.h"
+#include "bin_reader.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>   // For INFINITY
+
+typedef struct {
+    const ScanPredicate *preds;
+    size_t num_preds;
+    ScanColumn *columns;  // preds resolved for current_scrip
+    bool resolved;
+    size_t current_scrip; // Scrip whose matches are being counted
+    size_t current_matches;
+    size_t scrips_matched;
+} ScanContext;
+
+static void flush_scrip(const BinFile *bf, ScanContext *sc) {
+    if (sc->current_matches == 0) return;
+    printf("%s %zu\n", bf->scrips[sc->current_scrip].name, sc->current_matches);
+    sc->scrips_matched++;
+    sc->current_matches = 0;
+}
+
+static bool count_matching_rows(const BinFile *bf, size_t scrip_index, size_t row_begin, size_t row_end, void *ctx) {
+    ScanContext *sc = ctx;
+    if (scrip_index != sc->current_scrip || !sc->resolved) {
+        flush_scrip(bf, sc);
+        sc->current_scrip = scrip_index;
+        bin_resolve_predicates(bf, &bf->scrips[scrip_index], sc->preds, sc->num_preds, sc->columns);
+        sc->resolved = true;
+    }
+    for (size_t row = row_begin; row < row_end; ++row) {
+        if (bin_row_matches(sc->columns, sc->num_preds, row)) sc->current_matches++;
+    }
+    return true;
+}
+
+static bool parse_bound(const char *text, size_t len, double open_value, double *out) {
+    if (len == 0) {
+        *out = open_value;
+        return true;
+    }
+    char buf[64];
+    if (len >= sizeof(buf)) return false;
+    memcpy(buf, text, len);
+    buf[len] = '\0';
+    char *end;
+    *out = strtod(buf, &end);
+    return end != buf && *end == '\0';
+}
+
+static bool parse_spec(const BinFile *bf, const char *spec, ScanPredicate *out) {
+    const char *first = strchr(spec, ':');
+    const char *second = first ? strchr(first + 1, ':') : NULL;
+    if (!first || !second) return false;
+
+    char key[MAX_FIELD_KEY_LEN + 1];
+    size_t key_len = (size_t)(first - spec);
+    if (key_len == 0 || key_len > MAX_FIELD_KEY_LEN) return false;
+    memcpy(key, spec, key_len);
+    key[key_len] = '\0';
+
+    out->field = find_schema_field(&bf->schema, key);
+    if (out->field < 0) {
+        fprintf(stderr, "❌ Unknown field '%s' in scan spec %s\n", key, spec);
+        return false;
+    }
+    return parse_bound(first + 1, (size_t)(second - first - 1), -INFINITY, &out->min) &&
+           parse_bound(second + 1, strlen(second + 1), INFINITY, &out->max);
+}
+
+int run_scan(const char *bin_path, const char *const *specs, size_t num_specs) {
+    BinFile bf;
+    if (!bin_open(bin_path, &bf)) return 1;
+
+    ScanPredicate *preds = calloc(num_specs + 1, sizeof(ScanPredicate));
+    ScanColumn *columns = calloc(num_specs + 1, sizeof(ScanColumn));
+    if (!preds || !columns) {
+        perror("❌ Failed to allocate scan predicates");
+        free(preds);
+        free(columns);
+        bin_close(&bf);
+        return 1;
+    }
+    for (size_t i = 0; i < num_specs; ++i) {
+        if (!parse_spec(&bf, specs[i], &preds[i])) {
+            fprintf(stderr, "❌ Invalid scan spec '%s', expected key:min:max\n", specs[i]);
+            free(preds);
+            free(columns);
+            bin_close(&bf);
+            return 1;
+        }
+    }
+    if (bf.schema.zone_block_bars == 0) {
+        printf("ℹ️ %s has no zone maps, every row will be read\n", bin_path);
+    }
+
+    ScanContext sc = { preds, num_specs, columns, false, 0, 0, 0 };
+    ScanStats stats;
+    bin_scan_blocks(&bf, preds, num_specs, count_matching_rows, &sc, &stats);
+    flush_scrip(&bf, &sc);
+
+    printf("📈 %zu scrips matched; read %zu of %zu blocks, %.2f of %.2f MB (%.1f%%)\n",
+           sc.scrips_matched, stats.blocks_matched, stats.blocks_total,
+           (double)stats.bytes_touched / (1024.0 * 1024.0), (double)stats.bytes_total / (1024.0 * 1024.0),
+           stats.bytes_total ? 100.0 * (double)stats.bytes_touched / (double)stats.bytes_total : 0.0);
+
+    free(preds);
+    free(columns);
+    bin_close(&bf);
+    return 0;
+}
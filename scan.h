@@ -0,0 +1,14 @@
+#ifndef SCAN_H
+#define SCAN_H
+
+#include <stddef.h>
+
+// --- Universe-wide predicate scan ---
+// Each spec is "key:min:max" on a field key from the file header (e.g.
+// "c:1000:" for close >= 1000, "t:1700000000:" for recent bars); an empty
+// bound is open. Prints every scrip with at least one row matching all specs,
+// then how many zone map blocks and bytes the scan had to touch.
+// Returns 0 on success, 1 on errors.
+int run_scan(const char *bin_path, const char *const *specs, size_t num_specs);
+
+#endif // SCAN_H
@@ -0,0 +1,379 @@
+#include "schema.h"
+#include <stdio.h>
+#include <stdlib.h> // For strtof
+#include <string.h>
+
+const FieldDesc COMPILED_SCHEMA_FIELDS[TOTAL_KEYS_CONST] = {
+#define X(id, key, name) { FIELD_TYPE_FLOAT32, sizeof(float), key, name },
+    SCRIP_FLOAT_FIELDS(X)
+#undef X
+#define X(id, key, name) { FIELD_TYPE_LONG, sizeof(int64_t), key, name },
+    SCRIP_LONG_FIELDS(X)
+#undef X
+};
+
+// Column layout of files written before the format header existed. Those
+// stored native `long int`; every host they were written on was LP64.
+static const FieldDesc LEGACY_V2_FIELDS[] = {
+    { FIELD_TYPE_FLOAT32, sizeof(float), "o", "Open" },
+    { FIELD_TYPE_FLOAT32, sizeof(float), "h", "High" },
+    { FIELD_TYPE_FLOAT32, sizeof(float), "l", "Low" },
+    { FIELD_TYPE_FLOAT32, sizeof(float), "c", "Close" },
+    { FIELD_TYPE_LONG, sizeof(int64_t), "t", "Timestamp" },
+    { FIELD_TYPE_LONG, sizeof(int64_t), "v", "Volume" },
+};
+
+static bool write_short_string(FILE *fout, const char *s) {
+    unsigned char len = (unsigned char)strlen(s);
+    if (fwrite(&len, sizeof(unsigned char), 1, fout) != 1) return false;
+    return fwrite(s, sizeof(char), len, fout) == len;
+}
+
+static bool read_short_string(FILE *fin, char *out, size_t max_len) {
+    unsigned char len;
+    if (fread(&len, sizeof(unsigned char), 1, fin) != 1) return false;
+    if (len > max_len) return false;
+    if (fread(out, sizeof(char), len, fin) != len) return false;
+    out[len] = '\0';
+    return true;
+}
+
+static void compute_field_offsets(FileSchema *schema) {
+    schema->record_size = 0;
+    for (uint32_t i = 0; i < schema->field_count; ++i) {
+        schema->field_offset[i] = schema->record_size;
+        schema->record_size += schema->fields[i].width;
+    }
+}
+
+uint32_t indicator_column_count(const IndicatorSpec *spec) {
+    return spec->kind == INDICATOR_BOLLINGER ? 3 : 1;
+}
+
+size_t indicator_state_doubles(const IndicatorSpec *spec) {
+    switch (spec->kind) {
+    case INDICATOR_SMA: return 2 + spec->period;       // count, sum, window
+    case INDICATOR_EMA: return 3;                      // count, seed sum, ema
+    case INDICATOR_RSI: return 4;                      // count, previous close, average gain, average loss
+    case INDICATOR_BOLLINGER: return 3 + spec->period; // count, sum, sum of squares, window
+    default: return 0;
+    }
+}
+
+static bool valid_indicator(const IndicatorSpec *spec) {
+    return spec->kind >= INDICATOR_SMA && spec->kind <= INDICATOR_BOLLINGER &&
+           spec->period > 0 && spec->period <= MAX_INDICATOR_PERIOD;
+}
+
+// Shortest decimal form of v that reads back as the same float, so distinct
+// standard deviations never share a key.
+static void format_stddev(char *buf, size_t size, float v) {
+    for (int precision = 1; precision <= 9; ++precision) {
+        snprintf(buf, size, "%.*g", precision, v);
+        if (strtof(buf, NULL) == v) return;
+    }
+}
+
+// Appends the float32 columns of one indicator to the schema's field list.
+// Fails if a key or name does not fit its field.
+static bool add_indicator_fields(FileSchema *schema, const IndicatorSpec *spec) {
+    static const char *const BAND_KEYS[3] = { "bbm", "bbu", "bbl" };
+    static const char *const BAND_NAMES[3] = { "BB mid", "BB upper", "BB lower" };
+    char stddev[32];
+    format_stddev(stddev, sizeof(stddev), spec->num_stddev);
+    for (uint32_t c = 0; c < indicator_column_count(spec); ++c) {
+        FieldDesc *f = &schema->fields[schema->field_count++];
+        f->type = FIELD_TYPE_FLOAT32;
+        f->width = sizeof(float);
+        int key_len = 0, name_len = 0;
+        switch (spec->kind) {
+        case INDICATOR_SMA:
+            key_len = snprintf(f->key, sizeof(f->key), "sma%u", spec->period);
+            name_len = snprintf(f->name, sizeof(f->name), "SMA(%u)", spec->period);
+            break;
+        case INDICATOR_EMA:
+            key_len = snprintf(f->key, sizeof(f->key), "ema%u", spec->period);
+            name_len = snprintf(f->name, sizeof(f->name), "EMA(%u)", spec->period);
+            break;
+        case INDICATOR_RSI:
+            key_len = snprintf(f->key, sizeof(f->key), "rsi%u", spec->period);
+            name_len = snprintf(f->name, sizeof(f->name), "RSI(%u)", spec->period);
+            break;
+        case INDICATOR_BOLLINGER:
+            key_len = snprintf(f->key, sizeof(f->key), "%s%ux%s", BAND_KEYS[c], spec->period, stddev);
+            name_len = snprintf(f->name, sizeof(f->name), "%s(%u,%s)", BAND_NAMES[c], spec->period, stddev);
+            break;
+        }
+        // A truncated key could collide with another indicator's.
+        if (key_len < 0 || (size_t)key_len >= sizeof(f->key) || name_len < 0 || (size_t)name_len >= sizeof(f->name)) {
+            fprintf(stderr, "❌ Indicator column key %s... is too long (max %d characters)\n", f->key, MAX_FIELD_KEY_LEN);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Fills the indicator fields of the schema from its spec list.
+static bool layout_indicators(FileSchema *schema) {
+    if (schema->indicator_count > MAX_INDICATORS) {
+        fprintf(stderr, "❌ Too many indicators: %u (max %d)\n", schema->indicator_count, MAX_INDICATORS);
+        return false;
+    }
+    schema->first_indicator_field = schema->field_count;
+    schema->indicator_state_bytes = 0;
+    for (uint32_t i = 0; i < schema->indicator_count; ++i) {
+        const IndicatorSpec *spec = &schema->indicators[i];
+        if (!valid_indicator(spec)) {
+            fprintf(stderr, "❌ Invalid indicator %u (kind %u, period %u)\n", i, spec->kind, spec->period);
+            return false;
+        }
+        if (schema->field_count + indicator_column_count(spec) > MAX_SCHEMA_FIELDS) {
+            fprintf(stderr, "❌ Indicator columns exceed %d fields\n", MAX_SCHEMA_FIELDS);
+            return false;
+        }
+        if (!add_indicator_fields(schema, spec)) return false;
+        schema->indicator_state_bytes += indicator_state_doubles(spec) * sizeof(double);
+    }
+    for (uint32_t i = schema->first_indicator_field; i < schema->field_count; ++i) {
+        if (find_schema_field(schema, schema->fields[i].key) != (int)i) {
+            fprintf(stderr, "❌ Indicator column %s is listed twice\n", schema->fields[i].key);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool compiled_file_schema(FileSchema *out_schema, const IndicatorSpec *indicators, uint32_t indicator_count) {
+    memset(out_schema, 0, sizeof(*out_schema));
+    out_schema->version = BIN_FORMAT_VERSION;
+    out_schema->field_count = TOTAL_KEYS_CONST;
+    out_schema->zone_block_bars = ZONE_MAP_BLOCK_BARS;
+    out_schema->column_alignment = BIN_COLUMN_ALIGNMENT;
+    memcpy(out_schema->fields, COMPILED_SCHEMA_FIELDS, sizeof(COMPILED_SCHEMA_FIELDS));
+    out_schema->indicator_count = indicator_count;
+    if (indicator_count > 0 && indicator_count <= MAX_INDICATORS) {
+        memcpy(out_schema->indicators, indicators, indicator_count * sizeof(IndicatorSpec));
+    }
+    bool ok = layout_indicators(out_schema);
+    compute_field_offsets(out_schema);
+    return ok;
+}
+
+bool same_indicators(const FileSchema *a, const FileSchema *b) {
+    if (a->indicator_count != b->indicator_count) return false;
+    for (uint32_t i = 0; i < a->indicator_count; ++i) {
+        const IndicatorSpec *x = &a->indicators[i], *y = &b->indicators[i];
+        if (x->kind != y->kind || x->period != y->period || x->num_stddev != y->num_stddev) return false;
+    }
+    return true;
+}
+
+bool write_schema_header(FILE *fout, const FileSchema *schema) {
+    uint32_t version = BIN_FORMAT_VERSION;
+    uint32_t byte_order_mark = BIN_BYTE_ORDER_MARK;
+    uint32_t field_count = schema->field_count;
+    uint32_t zone_block_bars = ZONE_MAP_BLOCK_BARS;
+    uint32_t column_alignment = BIN_COLUMN_ALIGNMENT;
+
+    if (fwrite(BIN_FORMAT_MAGIC, 1, BIN_FORMAT_MAGIC_LEN, fout) != BIN_FORMAT_MAGIC_LEN ||
+        fwrite(&version, sizeof(uint32_t), 1, fout) != 1 ||
+        fwrite(&byte_order_mark, sizeof(uint32_t), 1, fout) != 1 ||
+        fwrite(&field_count, sizeof(uint32_t), 1, fout) != 1 ||
+        fwrite(&zone_block_bars, sizeof(uint32_t), 1, fout) != 1 ||
+        fwrite(&column_alignment, sizeof(uint32_t), 1, fout) != 1) {
+        perror("❌ Failed to write format header");
+        return false;
+    }
+    for (uint32_t i = 0; i < field_count; ++i) {
+        const FieldDesc *f = &schema->fields[i];
+        if (fwrite(&f->type, sizeof(uint8_t), 1, fout) != 1 ||
+            fwrite(&f->width, sizeof(uint8_t), 1, fout) != 1 ||
+            !write_short_string(fout, f->key) ||
+            !write_short_string(fout, f->name)) {
+            perror("❌ Failed to write field descriptor");
+            return false;
+        }
+    }
+    if (fwrite(&schema->indicator_count, sizeof(uint32_t), 1, fout) != 1) {
+        perror("❌ Failed to write indicator count");
+        return false;
+    }
+    for (uint32_t i = 0; i < schema->indicator_count; ++i) {
+        const IndicatorSpec *spec = &schema->indicators[i];
+        if (fwrite(&spec->kind, sizeof(uint8_t), 1, fout) != 1 ||
+            fwrite(&spec->period, sizeof(uint32_t), 1, fout) != 1 ||
+            fwrite(&spec->num_stddev, sizeof(float), 1, fout) != 1) {
+            perror("❌ Failed to write indicator descriptor");
+            return false;
+        }
+    }
+    return true;
+}
+
+// Reads the v7 indicator list and checks it describes the last file columns.
+static bool read_indicator_list(FILE *fin, FileSchema *schema) {
+    if (fread(&schema->indicator_count, sizeof(uint32_t), 1, fin) != 1) {
+        fprintf(stderr, "❌ Failed to read indicator count\n");
+        return false;
+    }
+    if (schema->indicator_count > MAX_INDICATORS) {
+        fprintf(stderr, "❌ Invalid indicator count %u in format header\n", schema->indicator_count);
+        return false;
+    }
+    for (uint32_t i = 0; i < schema->indicator_count; ++i) {
+        IndicatorSpec *spec = &schema->indicators[i];
+        if (fread(&spec->kind, sizeof(uint8_t), 1, fin) != 1 ||
+            fread(&spec->period, sizeof(uint32_t), 1, fin) != 1 ||
+            fread(&spec->num_stddev, sizeof(float), 1, fin) != 1) {
+            fprintf(stderr, "❌ Failed to read indicator descriptor %u\n", i);
+            return false;
+        }
+    }
+
+    // Rebuild the indicator columns from the specs and compare them with the tail of the field list.
+    FileSchema expected = *schema;
+    uint32_t indicator_columns = 0;
+    for (uint32_t i = 0; i < schema->indicator_count; ++i) indicator_columns += indicator_column_count(&schema->indicators[i]);
+    if (indicator_columns > schema->field_count) {
+        fprintf(stderr, "❌ Indicator list does not match the field list\n");
+        return false;
+    }
+    expected.field_count = schema->field_count - indicator_columns;
+    if (!layout_indicators(&expected)) return false;
+    for (uint32_t i = expected.first_indicator_field; i < schema->field_count; ++i) {
+        const FieldDesc *want = &expected.fields[i], *have = &schema->fields[i];
+        if (have->type != want->type || have->width != want->width || strcmp(have->key, want->key) != 0) {
+            fprintf(stderr, "❌ Field %s does not match indicator column %s\n", have->key, want->key);
+            return false;
+        }
+    }
+    schema->first_indicator_field = expected.first_indicator_field;
+    schema->indicator_state_bytes = expected.indicator_state_bytes;
+    return true;
+}
+
+bool read_schema_header(FILE *fin, FileSchema *out_schema) {
+    char magic[BIN_FORMAT_MAGIC_LEN];
+    memset(out_schema, 0, sizeof(*out_schema));
+
+    if (fread(magic, 1, BIN_FORMAT_MAGIC_LEN, fin) != BIN_FORMAT_MAGIC_LEN) {
+        fprintf(stderr, "❌ File too short for a format header\n");
+        return false;
+    }
+
+    if (memcmp(magic, BIN_FORMAT_MAGIC, BIN_FORMAT_MAGIC_LEN) != 0) {
+        // No magic: legacy v2 layout, the first 8 bytes are end_of_all_headers.
+        out_schema->version = BIN_FORMAT_VERSION_LEGACY;
+        out_schema->field_count = sizeof(LEGACY_V2_FIELDS) / sizeof(LEGACY_V2_FIELDS[0]);
+        memcpy(out_schema->fields, LEGACY_V2_FIELDS, sizeof(LEGACY_V2_FIELDS));
+        out_schema->column_alignment = 1;
+        if (fseek(fin, 0, SEEK_SET) != 0) {
+            perror("❌ Failed to rewind legacy binary file");
+            return false;
+        }
+    } else {
+        if (fread(&out_schema->version, sizeof(uint32_t), 1, fin) != 1) {
+            fprintf(stderr, "❌ Failed to read format version\n");
+            return false;
+        }
+        if (out_schema->version < BIN_FORMAT_VERSION_SCHEMA || out_schema->version > BIN_FORMAT_VERSION) {
+            fprintf(stderr, "❌ Unsupported binary format version %u\n", out_schema->version);
+            return false;
+        }
+        if (out_schema->version >= BIN_FORMAT_VERSION_ALIGNED) {
+            uint32_t byte_order_mark;
+            if (fread(&byte_order_mark, sizeof(uint32_t), 1, fin) != 1) {
+                fprintf(stderr, "❌ Failed to read byte order mark\n");
+                return false;
+            }
+            if (byte_order_mark != BIN_BYTE_ORDER_MARK) {
+                fprintf(stderr, "❌ File was written on a host with a different byte order (mark 0x%08x)\n", byte_order_mark);
+                return false;
+            }
+        }
+        if (fread(&out_schema->field_count, sizeof(uint32_t), 1, fin) != 1) {
+            fprintf(stderr, "❌ Failed to read field count\n");
+            return false;
+        }
+        if (out_schema->version >= BIN_FORMAT_VERSION_ZONE_MAPS &&
+            fread(&out_schema->zone_block_bars, sizeof(uint32_t), 1, fin) != 1) {
+            fprintf(stderr, "❌ Failed to read zone map block size\n");
+            return false;
+        }
+        out_schema->column_alignment = 1;
+        if (out_schema->version >= BIN_FORMAT_VERSION_ALIGNED) {
+            if (fread(&out_schema->column_alignment, sizeof(uint32_t), 1, fin) != 1) {
+                fprintf(stderr, "❌ Failed to read column alignment\n");
+                return false;
+            }
+            if (out_schema->column_alignment == 0 ||
+                (out_schema->column_alignment & (out_schema->column_alignment - 1)) != 0) {
+                fprintf(stderr, "❌ Invalid column alignment %u\n", out_schema->column_alignment);
+                return false;
+            }
+        }
+        if (out_schema->field_count == 0 || out_schema->field_count > MAX_SCHEMA_FIELDS) {
+            fprintf(stderr, "❌ Invalid field count %u in format header\n", out_schema->field_count);
+            return false;
+        }
+        for (uint32_t i = 0; i < out_schema->field_count; ++i) {
+            FieldDesc *f = &out_schema->fields[i];
+            if (fread(&f->type, sizeof(uint8_t), 1, fin) != 1 ||
+                fread(&f->width, sizeof(uint8_t), 1, fin) != 1 ||
+                !read_short_string(fin, f->key, MAX_FIELD_KEY_LEN) ||
+                !read_short_string(fin, f->name, MAX_FIELD_NAME_LEN)) {
+                fprintf(stderr, "❌ Failed to read field descriptor %u\n", i);
+                return false;
+            }
+            if (f->width == 0) {
+                fprintf(stderr, "❌ Field %s has zero width\n", f->key);
+                return false;
+            }
+        }
+        if (out_schema->version >= BIN_FORMAT_VERSION_INDICATORS && !read_indicator_list(fin, out_schema)) return false;
+    }
+
+    if (out_schema->indicator_count == 0) out_schema->first_indicator_field = out_schema->field_count;
+    compute_field_offsets(out_schema);
+    return true;
+}
+
+int find_schema_field(const FileSchema *schema, const char *key) {
+    for (uint32_t i = 0; i < schema->field_count; ++i) {
+        if (strcmp(schema->fields[i].key, key) == 0) return (int)i;
+    }
+    return -1;
+}
+
+uint64_t schema_align(const FileSchema *schema, uint64_t offset) {
+    uint64_t a = schema->column_alignment;
+    return (offset + a - 1) & ~(a - 1);
+}
+
+uint64_t schema_column_offset(const FileSchema *schema, uint32_t field, uint64_t num_records) {
+    if (schema->column_alignment <= 1) {
+        size_t record_offset = field < schema->field_count ? schema->field_offset[field] : schema->record_size;
+        return record_offset * num_records;
+    }
+    uint64_t offset = 0;
+    for (uint32_t i = 0; i < field; ++i) offset += schema_align(schema, schema->fields[i].width * num_records);
+    return offset;
+}
+
+uint64_t schema_columns_bytes(const FileSchema *schema, uint64_t num_records) {
+    return schema_column_offset(schema, schema->field_count, num_records);
+}
+
+size_t schema_zone_blocks(const FileSchema *schema, uint64_t num_records) {
+    if (schema->zone_block_bars == 0) return 0;
+    return (size_t)((num_records + schema->zone_block_bars - 1) / schema->zone_block_bars);
+}
+
+uint64_t schema_state_offset(const FileSchema *schema, uint64_t num_records) {
+    uint64_t zone_map_bytes = (uint64_t)schema_zone_blocks(schema, num_records) * 2 * schema->record_size;
+    return schema_columns_bytes(schema, num_records) + schema_align(schema, zone_map_bytes);
+}
+
+uint64_t schema_block_bytes(const FileSchema *schema, uint64_t num_records) {
+    return schema_state_offset(schema, num_records) + schema_align(schema, schema->indicator_state_bytes);
+}
@@ -0,0 +1,168 @@
+#ifndef SCHEMA_H
+#define SCHEMA_H
+
+#include <stdio.h>   // For FILE*
+#include <stdbool.h>
+#include <stdint.h>  // For uint8_t, uint32_t
+
+// --- Bar schema ---
+// Every per-bar column is declared exactly once here as X(ID, json_key, display_name).
+// The JSON parser, the binary writer and the binary reader are all expanded from
+// these lists, so adding a column (open interest, delivery qty, ...) is a one-line
+// change and the generated code stays fully unrolled.
+// Float columns are written before long columns, each in the order listed.
+#define SCRIP_FLOAT_FIELDS(X) \
+    X(OPEN,  "o", "Open")     \
+    X(HIGH,  "h", "High")     \
+    X(LOW,   "l", "Low")      \
+    X(CLOSE, "c", "Close")
+
+#define SCRIP_LONG_FIELDS(X)       \
+    X(TIMESTAMP, "t", "Timestamp") \
+    X(VOLUME,    "v", "Volume")
+
+enum {
+#define X(id, key, name) FLOAT_FIELD_##id,
+    SCRIP_FLOAT_FIELDS(X)
+#undef X
+    NUM_FLOAT_KEYS_CONST
+};
+
+enum {
+#define X(id, key, name) LONG_FIELD_##id,
+    SCRIP_LONG_FIELDS(X)
+#undef X
+    NUM_LONG_KEYS_CONST
+};
+
+#define TOTAL_KEYS_CONST (NUM_FLOAT_KEYS_CONST + NUM_LONG_KEYS_CONST)
+
+// --- On-disk format header ---
+// v2 files (no magic) start directly with the end_of_all_headers offset.
+// From v3 on the file starts with a magic, a version and the field list:
+//   char magic[8] | uint32 version | (v5+) uint32 byte_order_mark | uint32 field_count |
+//   (v4+) uint32 zone_block_bars | (v5+) uint32 column_alignment |
+//   field_count x { uint8 type | uint8 width | uint8 key_len | key | uint8 name_len | name }
+// Integers in the header and directory are in the writer's byte order; from v5
+// the byte order mark lets a reader on a different host reject the file.
+#define BIN_FORMAT_MAGIC "CDOBIN\0"
+#define BIN_FORMAT_MAGIC_LEN 8
+#define BIN_FORMAT_VERSION_LEGACY 2
+#define BIN_FORMAT_VERSION_SCHEMA 3
+#define BIN_FORMAT_VERSION_ZONE_MAPS 4
+#define BIN_FORMAT_VERSION_ALIGNED 5
+#define BIN_FORMAT_VERSION_CHECKSUMS 6
+#define BIN_FORMAT_VERSION_INDICATORS 7
+#define BIN_FORMAT_VERSION BIN_FORMAT_VERSION_INDICATORS
+#define BIN_BYTE_ORDER_MARK 0x01020304u
+
+// --- Aligned column layout ---
+// From v5 every scrip block starts on a BIN_COLUMN_ALIGNMENT boundary and each
+// column (and the zone map) is zero-padded to the next boundary, so every
+// column can be read in place with aligned vector loads. Directory entries
+// also carry the record count, as it can no longer be derived from the size:
+//   uint8 name_len | name | uint64 data_start | uint64 data_end | (v5+) uint64 record_count |
+//   (v6+) uint32 block_crc
+// data_end is the end of the (padded) columns, i.e. where the zone map starts.
+// Older files are packed: a column alignment of 1.
+#define BIN_COLUMN_ALIGNMENT 64
+
+// --- Checksums ---
+// From v6 the uint64 end_of_all_headers is followed by a uint32 CRC32C of
+// bytes [0, end_of_all_headers) of the file, computed with that field itself
+// read as zero. Each directory entry's block_crc is the CRC32C of its whole
+// block, data_start up to the end of the padded zone map.
+
+// --- Zone maps ---
+// From v4 each scrip's columns are followed by one summary per block of
+// ZONE_MAP_BLOCK_BARS bars (the last block may be shorter). A summary holds,
+// for every field in file order, the block's min then max value, each in the
+// field's own type and width: 2 * record_size bytes per block.
+// The block size is recorded in the header; 0 means the file has no zone maps.
+#define ZONE_MAP_BLOCK_BARS 64
+
+// --- Indicator columns ---
+// From v7 the field list is followed by the indicators computed at ingest:
+//   uint32 indicator_count | indicator_count x { uint8 kind | uint32 period | float32 num_stddev }
+// Their float32 columns are the last fields of the file, in indicator order
+// (Bollinger bands add three: middle, upper, lower). Each scrip block ends
+// with the indicators' rolling state after the zone map, as doubles, padded
+// to a column boundary, so a scrip can be extended by new bars without
+// rereading its history. Bars before an indicator's warm-up are NaN.
+#define MAX_INDICATORS 16
+#define MAX_INDICATOR_COLUMNS (3 * MAX_INDICATORS)
+#define MAX_INDICATOR_PERIOD 10000
+
+typedef enum {
+    INDICATOR_SMA = 1,
+    INDICATOR_EMA = 2,
+    INDICATOR_RSI = 3,      // Wilder smoothing
+    INDICATOR_BOLLINGER = 4 // SMA +/- num_stddev population standard deviations
+} IndicatorKind;
+
+typedef struct {
+    uint8_t kind;      // IndicatorKind
+    uint32_t period;   // Bars in the window
+    float num_stddev;  // Bollinger only, 0 otherwise
+} IndicatorSpec;
+
+#define MAX_SCHEMA_FIELDS 64
+#define MAX_FIELD_KEY_LEN 15
+#define MAX_FIELD_NAME_LEN 31
+
+typedef enum {
+    FIELD_TYPE_FLOAT32 = 1,
+    FIELD_TYPE_LONG = 2 // Signed integer of `width` bytes; written as int64 since v5
+} FieldType;
+
+typedef struct {
+    uint8_t type;   // FieldType
+    uint8_t width;  // Bytes per value
+    char key[MAX_FIELD_KEY_LEN + 1];
+    char name[MAX_FIELD_NAME_LEN + 1];
+} FieldDesc;
+
+typedef struct {
+    uint32_t version;
+    uint32_t field_count;
+    uint32_t zone_block_bars; // 0 when the file has no zone maps
+    uint32_t column_alignment; // 1 for packed (pre-v5) files
+    FieldDesc fields[MAX_SCHEMA_FIELDS];
+    size_t field_offset[MAX_SCHEMA_FIELDS]; // Bytes per record before each field
+    size_t record_size;                     // Sum of all field widths
+    uint32_t indicator_count;               // v7+, 0 otherwise
+    IndicatorSpec indicators[MAX_INDICATORS];
+    uint32_t first_indicator_field;         // Index of the first indicator column
+    size_t indicator_state_bytes;           // Rolling state per scrip block
+} FileSchema;
+
+// Schema compiled into this binary, in on-disk column order.
+extern const FieldDesc COMPILED_SCHEMA_FIELDS[TOTAL_KEYS_CONST];
+
+// The layout this binary writes, as a reader would see it: the compiled
+// fields followed by the columns of `indicators`. False if they do not fit.
+bool compiled_file_schema(FileSchema *out_schema, const IndicatorSpec *indicators, uint32_t indicator_count);
+bool write_schema_header(FILE *fout, const FileSchema *schema);
+// Reads the format header, leaving fin positioned at end_of_all_headers.
+// Legacy v2 files are reported with the original OHLC + TV field list.
+bool read_schema_header(FILE *fin, FileSchema *out_schema);
+// Index of the field with the given key in the file schema, or -1.
+int find_schema_field(const FileSchema *schema, const char *key);
+
+// Block layout helpers; all offsets are relative to a scrip's data_start.
+uint64_t schema_align(const FileSchema *schema, uint64_t offset);
+uint64_t schema_column_offset(const FileSchema *schema, uint32_t field, uint64_t num_records);
+// Bytes from data_start to data_end.
+uint64_t schema_columns_bytes(const FileSchema *schema, uint64_t num_records);
+size_t schema_zone_blocks(const FileSchema *schema, uint64_t num_records);
+// Start of the indicator state, after the padded zone map.
+uint64_t schema_state_offset(const FileSchema *schema, uint64_t num_records);
+// Columns plus zone map, indicator state and padding: the distance to the next scrip block.
+uint64_t schema_block_bytes(const FileSchema *schema, uint64_t num_records);
+
+// Columns an indicator adds, and the doubles of rolling state it keeps.
+uint32_t indicator_column_count(const IndicatorSpec *spec);
+size_t indicator_state_doubles(const IndicatorSpec *spec);
+bool same_indicators(const FileSchema *a, const FileSchema *b);
+
+#endif // SCHEMA_H
@@ -0,0 +1,161 @@
+#ifdef __linux__
+#define _GNU_SOURCE // For loff_t
+#endif
+#include "spill.h"
+#include "binary_io.h" // For write_scrip_block
+#include "utils.h"     // For LOG_ENABLED
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#define SPILL_COPY_BUFFER_SIZE (1 << 20)
+
+void init_spill_store(SpillStore *spill, size_t memory_budget_bytes, const char *spill_dir) {
+    memset(spill, 0, sizeof(*spill));
+    spill->memory_budget_bytes = memory_budget_bytes;
+    const char *dir = spill_dir;
+    if (!dir || *dir == '\0') dir = getenv("TMPDIR");
+    if (!dir || *dir == '\0') dir = "/tmp";
+    strncpy(spill->spill_dir, dir, sizeof(spill->spill_dir) - 1);
+}
+
+static bool open_spill_file(SpillStore *spill) {
+    char path[sizeof(spill->spill_dir) + 32];
+    snprintf(path, sizeof(path), "%s/cdo_spill_XXXXXX", spill->spill_dir);
+    int fd = mkstemp(path);
+    if (fd == -1) {
+        perror("❌ Failed to create spill file");
+        return false;
+    }
+    // Unlinked right away so the space is reclaimed even if we crash.
+    unlink(path);
+    spill->fp = fdopen(fd, "w+b");
+    if (!spill->fp) {
+        perror("❌ Failed to open spill file stream");
+        close(fd);
+        return false;
+    }
+    if (LOG_ENABLED) printf("Spilling decoded columns to %s\n", spill->spill_dir);
+    return true;
+}
+
+static bool spill_scrip(SpillStore *spill, const FileSchema *layout, ScripInfo *scrip) {
+    long start = ftell(spill->fp);
+    if (start == -1L) { perror("ftell failed on spill file"); return false; }
+    if (!write_scrip_block(spill->fp, layout, scrip, &scrip->spill_crc)) {
+        perror("❌ Failed to write scrip block to spill file");
+        return false;
+    }
+    long end = ftell(spill->fp);
+    if (end == -1L) { perror("ftell failed on spill file"); return false; }
+
+    scrip->is_spilled = true;
+    scrip->spill_offset = (uint64_t)start;
+    scrip->spill_length = (uint64_t)(end - start);
+    spill->bytes_spilled += scrip->spill_length;
+    spill->scrips_spilled++;
+    free_scrip_info_columns(scrip);
+    return true;
+}
+
+bool spill_if_over_budget(SpillStore *spill, const FileSchema *layout, ScripInfoArray *all_scrips_info) {
+    if (spill->memory_budget_bytes == 0 || all_scrips_info->count == 0) return true;
+
+    spill->resident_bytes += scrip_info_resident_bytes(&all_scrips_info->scrips[all_scrips_info->count - 1]);
+    if (spill->resident_bytes <= spill->memory_budget_bytes) return true;
+
+    if (!spill->fp && !open_spill_file(spill)) return false;
+
+    for (size_t i = spill->next_unspilled_index; i < all_scrips_info->count; ++i) {
+        ScripInfo *scrip = &all_scrips_info->scrips[i];
+        if (scrip->is_spilled || scrip->expected_count == 0) continue;
+        size_t scrip_bytes = scrip_info_resident_bytes(scrip);
+        if (!spill_scrip(spill, layout, scrip)) return false;
+        spill->resident_bytes -= scrip_bytes;
+    }
+    spill->next_unspilled_index = all_scrips_info->count;
+    return true;
+}
+
+static bool copy_with_buffer(int in_fd, uint64_t in_offset, FILE *fout, uint64_t length) {
+    char *buffer = malloc(SPILL_COPY_BUFFER_SIZE);
+    if (!buffer) {
+        perror("❌ Failed to allocate spill copy buffer");
+        return false;
+    }
+    while (length > 0) {
+        size_t chunk = length < SPILL_COPY_BUFFER_SIZE ? (size_t)length : SPILL_COPY_BUFFER_SIZE;
+        ssize_t got = pread(in_fd, buffer, chunk, (off_t)in_offset);
+        if (got <= 0) {
+            if (got < 0 && errno == EINTR) continue;
+            perror("❌ Failed to read back spill file");
+            free(buffer);
+            return false;
+        }
+        if (fwrite(buffer, 1, (size_t)got, fout) != (size_t)got) {
+            perror("❌ Failed to copy spilled block to output");
+            free(buffer);
+            return false;
+        }
+        in_offset += (uint64_t)got;
+        length -= (uint64_t)got;
+    }
+    free(buffer);
+    return true;
+}
+
+bool copy_spilled_scrip_block(SpillStore *spill, const ScripInfo *scrip, FILE *fout) {
+    if (!spill || !spill->fp) {
+        fprintf(stderr, "❌ Scrip %s is spilled but no spill file is open\n", scrip->scrip_name);
+        return false;
+    }
+    // Both streams must be flushed so the kernel-side copy sees every byte.
+    if (fflush(spill->fp) != 0 || fflush(fout) != 0) {
+        perror("❌ Failed to flush before copying spilled block");
+        return false;
+    }
+    int in_fd = fileno(spill->fp);
+    uint64_t in_offset = scrip->spill_offset;
+    uint64_t remaining = scrip->spill_length;
+
+#if defined(__linux__) && defined(SYS_copy_file_range)
+    long out_pos_long = ftell(fout);
+    if (out_pos_long == -1L) { perror("ftell failed before copy_file_range"); return false; }
+    loff_t off_in = (loff_t)in_offset;
+    loff_t off_out = (loff_t)out_pos_long;
+    int out_fd = fileno(fout);
+    while (remaining > 0) {
+        ssize_t copied = syscall(SYS_copy_file_range, in_fd, &off_in, out_fd, &off_out, (size_t)remaining, 0u);
+        if (copied < 0) {
+            if (errno == EINTR) continue;
+            // Cross-filesystem or unsupported: finish with a plain copy.
+            if (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP) break;
+            perror("❌ copy_file_range failed for spilled block");
+            return false;
+        }
+        if (copied == 0) break;
+        remaining -= (uint64_t)copied;
+    }
+    in_offset = (uint64_t)off_in;
+    // copy_file_range with explicit offsets leaves the fd position alone.
+    if (fseek(fout, (long)off_out, SEEK_SET) != 0) {
+        perror("❌ Failed to seek past copied spilled block");
+        return false;
+    }
+#endif
+
+    if (remaining > 0 && !copy_with_buffer(in_fd, in_offset, fout, remaining)) return false;
+    return true;
+}
+
+void close_spill_store(SpillStore *spill) {
+    if (spill->fp) {
+        fclose(spill->fp);
+        spill->fp = NULL;
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef SPILL_H
+#define SPILL_H
+
+#include "data_structures.h" // For ScripInfo, ScripInfoArray
+#include <stdio.h>           // For FILE*
+#include <stdint.h>
+
+// --- Out-of-core ingest ---
+// When the decoded columns of all scrips exceed memory_budget_bytes, every
+// scrip still held in memory is serialized (in its final on-disk block layout)
+// to an anonymous temporary file and its arrays are freed. The writer later
+// streams those blocks into the .bin with copy_file_range where available.
+typedef struct {
+    size_t memory_budget_bytes;  // 0 disables spilling
+    size_t resident_bytes;       // Decoded column bytes currently in memory
+    size_t next_unspilled_index; // Scrips before this index are already spilled
+    FILE *fp;                    // Opened lazily on the first spill
+    uint64_t bytes_spilled;
+    size_t scrips_spilled;
+    char spill_dir[256];
+} SpillStore;
+
+void init_spill_store(SpillStore *spill, size_t memory_budget_bytes, const char *spill_dir);
+// Call after each scrip is appended to all_scrips_info; layout is the file
+// schema the blocks will be written with.
+bool spill_if_over_budget(SpillStore *spill, const FileSchema *layout, ScripInfoArray *all_scrips_info);
+// Appends a spilled scrip's block to fout at its current position.
+bool copy_spilled_scrip_block(SpillStore *spill, const ScripInfo *scrip, FILE *fout);
+void close_spill_store(SpillStore *spill);
+
+#endif // SPILL_H
@@ -1,5 +1,6 @@
 #include "utils.h"
 #include <stdio.h> // For printf
+#include <sys/resource.h> // For getrusage
 
 clock_t lastTime; // Definition of the global variable
 
@@ -9,4 +10,14 @@ void printTimeSpent(const char *tag) {
         printf("🕒 %s: %.3f seconds\n", tag, time_spent);
     }
     lastTime = clock();
+}
+
+size_t getPeakRssBytes(void) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return (size_t)usage.ru_maxrss;         // Bytes on macOS
+#else
+    return (size_t)usage.ru_maxrss * 1024;  // Kilobytes on Linux
+#endif
 }
\ No newline at end of file
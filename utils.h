@@ -3,11 +3,14 @@
 
 #include <time.h>
 #include <stdbool.h>
+#include <stddef.h> // For size_t
 
 #define LOG_ENABLED false // Set to true for detailed logging
 
 extern clock_t lastTime; // Make lastTime accessible by main.c for initialization
 
 void printTimeSpent(const char *tag);
+// Peak resident set size of this process so far, in bytes (0 if unavailable).
+size_t getPeakRssBytes(void);
 
 #endif // UTILS_H
\ No newline at end of file
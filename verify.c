@@ -0,0 +1,289 @@
+#include "verify.h"
+#include "bin_reader.h"
+#include "data_structures.h"
+#include "indicators.h"
+#include "schema.h"
+#include "zip_parser.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h> // For PRId64
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h> // For sysconf
+
+#define VERIFY_JOBS_PER_THREAD 4
+
+typedef struct VerifyJob {
+    char filename[256];
+    char *content;
+    struct VerifyJob *next;
+} VerifyJob;
+
+typedef struct {
+    const BinFile *bf;
+    int field_column[TOTAL_KEYS_CONST]; // File column of each compiled field, -1 if absent
+
+    pthread_mutex_t queue_lock;
+    pthread_cond_t queue_not_empty;
+    pthread_cond_t queue_not_full;
+    VerifyJob *head;
+    VerifyJob *tail;
+    size_t queued;
+    size_t max_queued;
+    bool producer_done;
+
+    atomic_uchar *seen; // One flag per directory entry of the .bin
+    atomic_size_t scrips_checked;
+    atomic_size_t problems;
+} VerifyContext;
+
+static void report_problem(VerifyContext *vc, const char *fmt, const char *scrip_name, const char *detail) {
+    atomic_fetch_add(&vc->problems, 1);
+    // A single fprintf call per line keeps output from different workers intact.
+    fprintf(stderr, fmt, scrip_name, detail);
+}
+
+static void compare_float_column(VerifyContext *vc, const ScripInfo *scrip, const FloatArray *arr,
+                                 const unsigned char *col, const char *name) {
+    size_t n = scrip->expected_count;
+    if (arr->count > 0 && memcmp(col, arr->data, n * sizeof(float)) == 0) return;
+
+    for (size_t i = 0; i < n; ++i) {
+        float expected = arr->count > 0 ? arr->data[i] : 0.0f;
+        float actual;
+        memcpy(&actual, col + i * sizeof(float), sizeof(float));
+        if (memcmp(&expected, &actual, sizeof(float)) != 0) {
+            char detail[160];
+            snprintf(detail, sizeof(detail), "%s differs at index %zu (bin %.6g, zip %.6g)", name, i, actual, expected);
+            report_problem(vc, "❌ %s: %s\n", scrip->scrip_name, detail);
+            return;
+        }
+    }
+}
+
+static void compare_long_column(VerifyContext *vc, const ScripInfo *scrip, const BinScripEntry *entry,
+                                int field, const char *name) {
+    const LongArray *arr = &scrip->long_data_arrays[field];
+    const unsigned char *col = bin_column(vc->bf, entry, vc->field_column[NUM_FLOAT_KEYS_CONST + field]);
+    size_t n = scrip->expected_count;
+    if (arr->count > 0 && memcmp(col, arr->data, n * sizeof(int64_t)) == 0) return;
+
+    for (size_t i = 0; i < n; ++i) {
+        int64_t expected = arr->count > 0 ? arr->data[i] : 0;
+        int64_t actual;
+        memcpy(&actual, col + i * sizeof(int64_t), sizeof(int64_t));
+        if (expected != actual) {
+            char detail[160];
+            snprintf(detail, sizeof(detail), "%s differs at index %zu (bin %" PRId64 ", zip %" PRId64 ")", name, i, actual, expected);
+            report_problem(vc, "❌ %s: %s\n", scrip->scrip_name, detail);
+            return;
+        }
+    }
+}
+
+// Recomputes the indicator columns from the re-parsed close column, and the
+// rolling state that extend resumes from, and compares both with the .bin.
+static void verify_indicators(VerifyContext *vc, ScripInfo *scrip, const BinScripEntry *entry) {
+    const FileSchema *schema = &vc->bf->schema;
+    if (schema->indicator_count == 0) return;
+    if (!update_scrip_indicators(schema, scrip)) {
+        report_problem(vc, "❌ %s: %s\n", scrip->scrip_name, "could not recompute indicators");
+        return;
+    }
+    for (uint32_t c = 0; c + schema->first_indicator_field < schema->field_count; ++c) {
+        uint32_t field = schema->first_indicator_field + c;
+        compare_float_column(vc, scrip, &scrip->indicator_data_arrays[c], bin_column(vc->bf, entry, field),
+                             schema->fields[field].name);
+    }
+    const unsigned char *state = bin_indicator_state(vc->bf, entry);
+    if (memcmp(state, scrip->indicator_state, schema->indicator_state_bytes) != 0) {
+        report_problem(vc, "❌ %s: %s\n", scrip->scrip_name, "indicator state differs");
+    }
+}
+
+static void verify_scrip(VerifyContext *vc, ScripInfo *scrip) {
+    long idx = bin_find_scrip(vc->bf, scrip->scrip_name);
+    if (idx < 0) {
+        report_problem(vc, "❌ %s: %s\n", scrip->scrip_name, "missing from .bin");
+        return;
+    }
+    if (atomic_exchange(&vc->seen[idx], 1) != 0) {
+        report_problem(vc, "❌ %s: %s\n", scrip->scrip_name, "appears more than once in the zip");
+        return;
+    }
+    atomic_fetch_add(&vc->scrips_checked, 1);
+
+    const BinScripEntry *entry = &vc->bf->scrips[idx];
+    if (entry->num_records == 0) return; // Already reported by bin_check_offsets
+    if (entry->num_records != scrip->expected_count) {
+        char detail[96];
+        snprintf(detail, sizeof(detail), "record count differs (bin %zu, zip %zu)", entry->num_records, scrip->expected_count);
+        report_problem(vc, "❌ %s: %s\n", scrip->scrip_name, detail);
+        return;
+    }
+
+#define X(id, key, name) \
+    if (vc->field_column[FLOAT_FIELD_##id] >= 0) \
+        compare_float_column(vc, scrip, &scrip->float_data_arrays[FLOAT_FIELD_##id], \
+                             bin_column(vc->bf, entry, vc->field_column[FLOAT_FIELD_##id]), name);
+    SCRIP_FLOAT_FIELDS(X)
+#undef X
+#define X(id, key, name) \
+    if (vc->field_column[NUM_FLOAT_KEYS_CONST + LONG_FIELD_##id] >= 0) compare_long_column(vc, scrip, entry, LONG_FIELD_##id, name);
+    SCRIP_LONG_FIELDS(X)
+#undef X
+    verify_indicators(vc, scrip, entry);
+}
+
+static void *verify_worker(void *arg) {
+    VerifyContext *vc = arg;
+    for (;;) {
+        pthread_mutex_lock(&vc->queue_lock);
+        while (!vc->head && !vc->producer_done) pthread_cond_wait(&vc->queue_not_empty, &vc->queue_lock);
+        VerifyJob *job = vc->head;
+        if (!job) {
+            pthread_mutex_unlock(&vc->queue_lock);
+            return NULL;
+        }
+        vc->head = job->next;
+        if (!vc->head) vc->tail = NULL;
+        vc->queued--;
+        pthread_cond_signal(&vc->queue_not_full);
+        pthread_mutex_unlock(&vc->queue_lock);
+
+        ScripInfo scrip;
+        // Entries that fail to parse were skipped by ingest as well.
+        if (parse_json_to_scrip_info(job->content, job->filename, &scrip)) {
+            if (scrip_timestamps_increasing(&scrip, job->filename)) verify_scrip(vc, &scrip);
+            free_scrip_info_columns(&scrip);
+        }
+        free(job->content);
+        free(job);
+    }
+}
+
+static void enqueue_json_entry(const char *filename_in_zip, char *content, void *ctx) {
+    VerifyContext *vc = ctx;
+    VerifyJob *job = malloc(sizeof(VerifyJob));
+    if (!job) {
+        perror("❌ Failed to allocate verify job");
+        free(content);
+        atomic_fetch_add(&vc->problems, 1);
+        return;
+    }
+    strncpy(job->filename, filename_in_zip, sizeof(job->filename) - 1);
+    job->filename[sizeof(job->filename) - 1] = '\0';
+    job->content = content;
+    job->next = NULL;
+
+    pthread_mutex_lock(&vc->queue_lock);
+    while (vc->queued >= vc->max_queued) pthread_cond_wait(&vc->queue_not_full, &vc->queue_lock);
+    if (vc->tail) vc->tail->next = job;
+    else vc->head = job;
+    vc->tail = job;
+    vc->queued++;
+    pthread_cond_signal(&vc->queue_not_empty);
+    pthread_mutex_unlock(&vc->queue_lock);
+}
+
+static bool resolve_field_columns(VerifyContext *vc) {
+    bool ok = true;
+    for (int i = 0; i < TOTAL_KEYS_CONST; ++i) {
+        const FieldDesc *want = &COMPILED_SCHEMA_FIELDS[i];
+        vc->field_column[i] = find_schema_field(&vc->bf->schema, want->key);
+        if (vc->field_column[i] < 0) {
+            fprintf(stderr, "❌ Field %s is missing from the .bin\n", want->name);
+            atomic_fetch_add(&vc->problems, 1);
+            continue;
+        }
+        const FieldDesc *have = &vc->bf->schema.fields[vc->field_column[i]];
+        if (have->type != want->type || have->width != want->width) {
+            fprintf(stderr, "❌ Field %s has type %u / width %u in the .bin, expected %u / %u\n",
+                    want->name, have->type, have->width, want->type, want->width);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+int run_verify(const char *zip_path, const char *bin_path, int num_threads) {
+    if (num_threads <= 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = cores > 0 ? (int)cores : 1;
+    }
+
+    BinFile bf;
+    if (!bin_open(bin_path, &bf)) return 1;
+
+    VerifyContext vc;
+    memset(&vc, 0, sizeof(vc));
+    vc.bf = &bf;
+    vc.max_queued = (size_t)num_threads * VERIFY_JOBS_PER_THREAD;
+    atomic_init(&vc.scrips_checked, 0);
+    atomic_init(&vc.problems, bin_check_offsets(&bf, stderr));
+
+    if (!resolve_field_columns(&vc)) {
+        bin_close(&bf);
+        return 1;
+    }
+
+    vc.seen = calloc(bf.scrip_count + 1, sizeof(atomic_uchar));
+    pthread_t *threads = malloc((size_t)num_threads * sizeof(pthread_t));
+    if (!vc.seen || !threads) {
+        perror("❌ Failed to allocate verifier state");
+        free(vc.seen);
+        free(threads);
+        bin_close(&bf);
+        return 1;
+    }
+    pthread_mutex_init(&vc.queue_lock, NULL);
+    pthread_cond_init(&vc.queue_not_empty, NULL);
+    pthread_cond_init(&vc.queue_not_full, NULL);
+
+    int started = 0;
+    for (; started < num_threads; ++started) {
+        if (pthread_create(&threads[started], NULL, verify_worker, &vc) != 0) {
+            perror("❌ Failed to start verify worker");
+            break;
+        }
+    }
+
+    bool zip_ok = false;
+    if (started > 0) {
+        // Decompression stays on this thread; minizip handles are not thread-safe.
+        zip_ok = for_each_json_in_zip(zip_path, enqueue_json_entry, &vc);
+    }
+
+    pthread_mutex_lock(&vc.queue_lock);
+    vc.producer_done = true;
+    pthread_cond_broadcast(&vc.queue_not_empty);
+    pthread_mutex_unlock(&vc.queue_lock);
+    for (int i = 0; i < started; ++i) pthread_join(threads[i], NULL);
+
+    if (!zip_ok) {
+        fprintf(stderr, "❌ Source zip %s could not be read completely\n", zip_path);
+        atomic_fetch_add(&vc.problems, 1);
+    }
+    for (size_t i = 0; i < bf.scrip_count; ++i) {
+        if (!atomic_load(&vc.seen[i])) {
+            report_problem(&vc, "❌ %s: %s\n", bf.scrips[i].name, "in .bin but not in the zip");
+        }
+    }
+
+    size_t problems = atomic_load(&vc.problems);
+    size_t checked = atomic_load(&vc.scrips_checked);
+    if (problems == 0) {
+        printf("✅ Verified %zu scrips in %s against %s using %d threads\n", checked, bin_path, zip_path, started);
+    } else {
+        printf("❌ Verification found %zu problems (%zu scrips checked)\n", problems, checked);
+    }
+
+    pthread_cond_destroy(&vc.queue_not_full);
+    pthread_cond_destroy(&vc.queue_not_empty);
+    pthread_mutex_destroy(&vc.queue_lock);
+    free(threads);
+    free(vc.seen);
+    bin_close(&bf);
+    return problems == 0 ? 0 : 1;
+}
@@ -0,0 +1,11 @@
+#ifndef VERIFY_H
+#define VERIFY_H
+
+// --- Round-trip verifier ---
+// Re-parses every JSON entry of the source zip and compares each scrip's
+// columns bit for bit with the mapped .bin, spreading the parsing and the
+// comparison over num_threads workers (<= 0 picks the number of cores).
+// Only problems are printed. Returns 0 when the file matches, 1 otherwise.
+int run_verify(const char *zip_path, const char *bin_path, int num_threads);
+
+#endif // VERIFY_H
@@ -1,5 +1,6 @@
 #include "zip_parser.h"
 #include "data_structures.h" // Already included via zip_parser.h, but good for clarity
+#include "indicators.h"      // For update_scrip_indicators
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -7,18 +8,18 @@
 #include <minizip/unzip.h> // For zip operations
 
 // Static helper functions (not exposed in header)
-static int extract_long_array_from_json(const char *content, const char *array_key_prefix, LongArray *output_array) {
-    const char *p = strstr(content, array_key_prefix);
-    if (!p) return 0;
-    p += strlen(array_key_prefix);
+// Both value parsers start right after the '[' of an array and report where the
+// array ended, so the caller can continue scanning from there.
+static int extract_long_array_from_json(const char *p, LongArray *output_array, const char **array_end_out) {
     const char *end_of_array = strchr(p, ']');
     if (!end_of_array) return -1;
+    *array_end_out = end_of_array;
 
     int values_found = 0;
     char *current_pos = (char *)p;
     while (current_pos < end_of_array && *current_pos != '\0') {
         char *next_val_ptr;
-        long int value = strtol(current_pos, &next_val_ptr, 10);
+        int64_t value = strtoll(current_pos, &next_val_ptr, 10);
         if (current_pos == next_val_ptr) {
             if (*current_pos == ',' || isspace((unsigned char)*current_pos)) {
                 current_pos++;
@@ -37,12 +38,10 @@ static int extract_long_array_from_json(const char *content, const char *array_k
     return values_found > 0 ? 1 : 0;
 }
 
-static int extract_float_array_from_json(const char *content, const char *array_key_prefix, FloatArray *output_array) {
-    const char *p = strstr(content, array_key_prefix);
-    if (!p) return 0;
-    p += strlen(array_key_prefix);
+static int extract_float_array_from_json(const char *p, FloatArray *output_array, const char **array_end_out) {
     const char *end_of_array = strchr(p, ']');
     if (!end_of_array) return -1;
+    *array_end_out = end_of_array;
 
     int values_found = 0;
     char *current_pos = (char *)p;
@@ -67,38 +66,108 @@ static int extract_float_array_from_json(const char *content, const char *array_
     return values_found > 0 ? 1 : 0;
 }
 
-static bool parse_json_to_scrip_info(const char *content, const char *filename_in_zip, ScripInfo *out_scrip) {
-    const char *keys_prefix[] = {"\"o\":[", "\"h\":[", "\"l\":[", "\"c\":[", "\"t\":[", "\"v\":["};
-    const char *key_names[] = {"Open", "High", "Low", "Close", "Timestamp", "Volume"};
-    const int TOTAL_KEYS_CONST = NUM_FLOAT_KEYS_CONST + NUM_LONG_KEYS_CONST;
+// Compile-time key comparison: the literal length folds to a constant.
+#define JSON_KEY_EQUALS(key_ptr, key_len, literal) \
+    ((key_len) == sizeof(literal) - 1 && memcmp((key_ptr), (literal), sizeof(literal) - 1) == 0)
 
+// Bit position of each schema field in the "already parsed" mask.
+enum {
+#define X(id, key, name) PARSED_BIT_FLOAT_##id = FLOAT_FIELD_##id,
+    SCRIP_FLOAT_FIELDS(X)
+#undef X
+#define X(id, key, name) PARSED_BIT_LONG_##id = NUM_FLOAT_KEYS_CONST + LONG_FIELD_##id,
+    SCRIP_LONG_FIELDS(X)
+#undef X
+};
+_Static_assert(TOTAL_KEYS_CONST <= 64, "parsed_mask holds one bit per schema field");
+
+// Closing quote of the JSON string whose contents start at s, honouring
+// backslash escapes, or NULL if the string is unterminated.
+static const char *json_string_end(const char *s) {
+    for (; *s; ++s) {
+        if (*s == '\\') {
+            if (!s[1]) return NULL;
+            ++s;
+        } else if (*s == '"') {
+            return s;
+        }
+    }
+    return NULL;
+}
+
+bool parse_json_to_scrip_info(const char *content, const char *filename_in_zip, ScripInfo *out_scrip) {
     for (int i = 0; i < NUM_FLOAT_KEYS_CONST; ++i) init_float_array(&out_scrip->float_data_arrays[i]);
     for (int i = 0; i < NUM_LONG_KEYS_CONST; ++i) init_long_array(&out_scrip->long_data_arrays[i]);
+    memset(out_scrip->indicator_data_arrays, 0, sizeof(out_scrip->indicator_data_arrays)); // Filled by the indicator stage
+    out_scrip->indicator_state = NULL;
+    out_scrip->indicator_state_len = 0;
     out_scrip->expected_count = 0;
     out_scrip->scrip_name_len = 0;
     out_scrip->scrip_name[0] = '\0';
+    out_scrip->is_spilled = false;
+    out_scrip->spill_offset = 0;
+    out_scrip->spill_length = 0;
 
     bool any_data_extracted = false;
-    bool error_occurred = false;
+    uint64_t parsed_mask = 0;
 
-    for (int i = 0; i < TOTAL_KEYS_CONST; ++i) {
-        int result;
-        if (i < NUM_FLOAT_KEYS_CONST) {
-            result = extract_float_array_from_json(content, keys_prefix[i], &out_scrip->float_data_arrays[i]);
-        } else {
-            result = extract_long_array_from_json(content, keys_prefix[i], &out_scrip->long_data_arrays[i - NUM_FLOAT_KEYS_CONST]);
+    // Single pass over the document: every `"key":[` is dispatched to the schema
+    // field with that key. The first occurrence of a key wins, as before.
+    const char *p = content;
+    while ((p = strchr(p, '"')) != NULL) {
+        const char *key = p + 1;
+        const char *key_end = json_string_end(key);
+        if (!key_end) break;
+        size_t key_len = (size_t)(key_end - key);
+        p = key_end + 1;
+        if (p[0] == ':' && p[1] == '"') {
+            // String value: skip it whole so its contents are never read as a key.
+            const char *value_end = json_string_end(p + 2);
+            if (!value_end) break;
+            p = value_end + 1;
+            continue;
         }
+        if (p[0] != ':' || p[1] != '[') continue;
 
-        if (result == 1) {
-            any_data_extracted = true;
-        } else if (result == -1) {
-            fprintf(stderr, "❌ Error parsing data for key %s in %s\n", key_names[i], filename_in_zip);
-            error_occurred = true;
-            break;
+        const char *values = p + 2;
+        const char *array_end = values;
+        int result = 0;
+
+        if (0) {
+        }
+#define X(id, json_key, name)                                                                          \
+        else if (JSON_KEY_EQUALS(key, key_len, json_key)) {                                            \
+            if (parsed_mask & (1ULL << PARSED_BIT_FLOAT_##id)) continue;                               \
+            parsed_mask |= 1ULL << PARSED_BIT_FLOAT_##id;                                              \
+            result = extract_float_array_from_json(values, &out_scrip->float_data_arrays[FLOAT_FIELD_##id], &array_end); \
+            if (result == -1) {                                                                        \
+                fprintf(stderr, "❌ Error parsing data for key %s in %s\n", name, filename_in_zip);    \
+                goto cleanup_and_fail;                                                                 \
+            }                                                                                          \
         }
+        SCRIP_FLOAT_FIELDS(X)
+#undef X
+#define X(id, json_key, name)                                                                          \
+        else if (JSON_KEY_EQUALS(key, key_len, json_key)) {                                            \
+            if (parsed_mask & (1ULL << PARSED_BIT_LONG_##id)) continue;                                \
+            parsed_mask |= 1ULL << PARSED_BIT_LONG_##id;                                               \
+            result = extract_long_array_from_json(values, &out_scrip->long_data_arrays[LONG_FIELD_##id], &array_end); \
+            if (result == -1) {                                                                        \
+                fprintf(stderr, "❌ Error parsing data for key %s in %s\n", name, filename_in_zip);    \
+                goto cleanup_and_fail;                                                                 \
+            }                                                                                          \
+        }
+        SCRIP_LONG_FIELDS(X)
+#undef X
+        else {
+            continue;
+        }
+
+        if (result == 1) any_data_extracted = true;
+        p = array_end;
     }
 
-    if (error_occurred || !any_data_extracted) {
+    if (!any_data_extracted) {
         goto cleanup_and_fail;
     }
 
@@ -106,30 +175,22 @@ static bool parse_json_to_scrip_info(const char *content, const char *filename_i
     size_t current_expected_count = 0;
     bool size_mismatch = false;
 
-    for (int i = 0; i < NUM_FLOAT_KEYS_CONST; ++i) {
-        if (out_scrip->float_data_arrays[i].count > 0) {
-            if (!first_populated_array_found) {
-                current_expected_count = out_scrip->float_data_arrays[i].count;
-                first_populated_array_found = true;
-            } else if (out_scrip->float_data_arrays[i].count != current_expected_count) {
-                size_mismatch = true;
-                break;
-            }
-        }
-    }
-    if (!size_mismatch) {
-        for (int i = 0; i < NUM_LONG_KEYS_CONST; ++i) {
-            if (out_scrip->long_data_arrays[i].count > 0) {
-                if (!first_populated_array_found) {
-                    current_expected_count = out_scrip->long_data_arrays[i].count;
-                    first_populated_array_found = true;
-                } else if (out_scrip->long_data_arrays[i].count != current_expected_count) {
-                    size_mismatch = true;
-                    break;
-                }
-            }
-        }
+#define CHECK_COLUMN_COUNT(column_count)                          \
+    if ((column_count) > 0) {                                     \
+        if (!first_populated_array_found) {                       \
+            current_expected_count = (column_count);              \
+            first_populated_array_found = true;                   \
+        } else if ((column_count) != current_expected_count) {    \
+            size_mismatch = true;                                 \
+        }                                                         \
     }
+#define X(id, key, name) CHECK_COLUMN_COUNT(out_scrip->float_data_arrays[FLOAT_FIELD_##id].count)
+    SCRIP_FLOAT_FIELDS(X)
+#undef X
+#define X(id, key, name) CHECK_COLUMN_COUNT(out_scrip->long_data_arrays[LONG_FIELD_##id].count)
+    SCRIP_LONG_FIELDS(X)
+#undef X
+#undef CHECK_COLUMN_COUNT
 
     if (!first_populated_array_found || size_mismatch) {
         if (size_mismatch) {
@@ -161,24 +222,36 @@ cleanup_and_fail:
     return false;
 }
 
+bool scrip_timestamps_increasing(const ScripInfo *scrip, const char *filename_in_zip) {
+    const LongArray *t = &scrip->long_data_arrays[LONG_FIELD_TIMESTAMP];
+    for (size_t i = 1; i < t->count; ++i) {
+        if (t->data[i] <= t->data[i - 1]) {
+            fprintf(stderr, "❌ %s: timestamps are not strictly increasing at bar %zu\n", filename_in_zip, i);
+            return false;
+        }
+    }
+    return true;
+}
 
-void read_zip_and_parse_data(const char *zip_path, ScripInfoArray *all_scrips_info) {
+bool for_each_json_in_zip(const char *zip_path, ZipJsonHandler handler, void *ctx) {
     unzFile zip = unzOpen(zip_path);
     if (!zip) {
         fprintf(stderr, "❌ Failed to open zip: %s\n", zip_path);
-        return;
+        return false;
     }
 
     if (unzGoToFirstFile(zip) != UNZ_OK) {
         printf("ℹ️ No files in zip: %s\n", zip_path);
         unzClose(zip);
-        return;
+        return true;
     }
 
+    bool all_entries_read = true;
     do {
         char filename_in_zip[256];
         unz_file_info file_info;
         if (unzGetCurrentFileInfo(zip, &file_info, filename_in_zip, sizeof(filename_in_zip), NULL, 0, NULL, 0) != UNZ_OK) {
+            all_entries_read = false;
             continue;
         }
 
@@ -188,6 +261,7 @@ void read_zip_and_parse_data(const char *zip_path, ScripInfoArray *all_scrips_in
                 if (!buffer) {
                     fprintf(stderr, "❌ Memory allocation failed for %s content\n", filename_in_zip);
                     unzCloseCurrentFile(zip);
+                    all_entries_read = false;
                     continue;
                 }
                 int read_size = unzReadCurrentFile(zip, buffer, file_info.uncompressed_size);
@@ -196,18 +270,58 @@ void read_zip_and_parse_data(const char *zip_path, ScripInfoArray *all_scrips_in
                            filename_in_zip, (long unsigned)file_info.uncompressed_size, read_size);
                     free(buffer);
                     unzCloseCurrentFile(zip);
+                    all_entries_read = false;
                     continue;
                 }
                 buffer[file_info.uncompressed_size] = '\0';
-
-                ScripInfo current_scrip_data;
-                if (parse_json_to_scrip_info(buffer, filename_in_zip, &current_scrip_data)) {
-                    add_to_scrip_info_array(all_scrips_info, current_scrip_data);
-                }
-                free(buffer);
                 unzCloseCurrentFile(zip);
+
+                handler(filename_in_zip, buffer, ctx);
+            } else {
+                all_entries_read = false;
             }
         }
     } while (unzGoToNextFile(zip) == UNZ_OK);
     unzClose(zip);
-}
\ No newline at end of file
+    return all_entries_read;
+}
+
+typedef struct {
+    const FileSchema *layout;
+    ScripInfoArray *all_scrips_info;
+    SpillStore *spill;
+} IngestContext;
+
+static void ingest_json_entry(const char *filename_in_zip, char *content, void *ctx) {
+    IngestContext *ingest = ctx;
+    ScripInfo current_scrip_data;
+    if (parse_json_to_scrip_info(content, filename_in_zip, &current_scrip_data)) {
+        // Rows are stored in source order, so out-of-order bars would break time-range queries.
+        if (!scrip_timestamps_increasing(&current_scrip_data, filename_in_zip)) {
+            fprintf(stderr, "❌ Skipping %s\n", current_scrip_data.scrip_name);
+            free_scrip_info_columns(&current_scrip_data);
+            free(content);
+            return;
+        }
+        // Indicators are computed while the freshly parsed columns are still hot in cache.
+        if (!update_scrip_indicators(ingest->layout, &current_scrip_data)) {
+            fprintf(stderr, "❌ Failed to compute indicators for %s, skipping it\n", current_scrip_data.scrip_name);
+            free_scrip_info_columns(&current_scrip_data);
+            free(content);
+            return;
+        }
+        size_t before = ingest->all_scrips_info->count;
+        add_to_scrip_info_array(ingest->all_scrips_info, current_scrip_data);
+        // On failure the scrip was freed and not added, so there is nothing new to account for.
+        if (ingest->all_scrips_info->count > before && ingest->spill &&
+            !spill_if_over_budget(ingest->spill, ingest->layout, ingest->all_scrips_info)) {
+            fprintf(stderr, "❌ Spilling decoded columns failed, keeping them in memory\n");
+        }
+    }
+    free(content);
+}
+
+void read_zip_and_parse_data(const char *zip_path, const FileSchema *layout, ScripInfoArray *all_scrips_info, SpillStore *spill) {
+    IngestContext ingest = { layout, all_scrips_info, spill };
+    for_each_json_in_zip(zip_path, ingest_json_entry, &ingest);
+}
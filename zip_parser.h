@@ -2,7 +2,20 @@
 #define ZIP_PARSER_H
 
 #include "data_structures.h" // For ScripInfoArray
+#include "spill.h"           // For SpillStore
 
-void read_zip_and_parse_data(const char *zip_path, ScripInfoArray *all_scrips_info);
+// Parses one JSON document into out_scrip. On failure nothing is left allocated.
+bool parse_json_to_scrip_info(const char *content, const char *filename_in_zip, ScripInfo *out_scrip);
+// True when the scrip has no timestamps or they strictly increase, which the
+// time-range lookups of the query daemon rely on. Reports the first bad bar.
+bool scrip_timestamps_increasing(const ScripInfo *scrip, const char *filename_in_zip);
+// Called for every .json entry; the handler owns content and must free it.
+typedef void (*ZipJsonHandler)(const char *filename_in_zip, char *content, void *ctx);
+// Streams the decompressed .json entries of a zip to handler, in archive order.
+// Returns false if the zip could not be opened or an entry could not be read.
+bool for_each_json_in_zip(const char *zip_path, ZipJsonHandler handler, void *ctx);
+// Computes the indicators of layout for each scrip as soon as it is parsed.
+// spill may be NULL to keep every decoded scrip in memory.
+void read_zip_and_parse_data(const char *zip_path, const FileSchema *layout, ScripInfoArray *all_scrips_info, SpillStore *spill);
 
 #endif // ZIP_PARSER_H
\ No newline at end of file